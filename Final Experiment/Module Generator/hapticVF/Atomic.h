@@ -0,0 +1,107 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Atomic]
+Minimal atomic operations used to hand data between the loading, haptic
+and graphics threads without locks (the toolset has no <atomic>).
+Loads have acquire and stores have release semantics.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+// returns the current value
+inline long atomicLoad(volatile long* value)
+{
+#if defined(_WIN32)
+	return InterlockedCompareExchange(value, 0, 0);
+#else
+	return __sync_fetch_and_add(value, 0);
+#endif
+}
+
+//=========================================================//
+
+// replaces the value
+inline void atomicStore(volatile long* value, long newValue)
+{
+#if defined(_WIN32)
+	InterlockedExchange(value, newValue);
+#else
+	__sync_synchronize();
+	*value = newValue;
+	__sync_synchronize();
+#endif
+}
+
+//=========================================================//
+
+// adds one and returns the new value
+inline long atomicIncrement(volatile long* value)
+{
+#if defined(_WIN32)
+	return InterlockedIncrement(value);
+#else
+	return __sync_add_and_fetch(value, 1);
+#endif
+}
+
+//=========================================================//
+
+// adds the amount and returns the new value
+inline long atomicAdd(volatile long* value, long amount)
+{
+#if defined(_WIN32)
+	return InterlockedExchangeAdd(value, amount) + amount;
+#else
+	return __sync_add_and_fetch(value, amount);
+#endif
+}
+
+//=========================================================//
+
+// replaces the value and returns the previous one
+inline long atomicExchange(volatile long* value, long newValue)
+{
+#if defined(_WIN32)
+	return InterlockedExchange(value, newValue);
+#else
+	__sync_synchronize();
+	return __sync_lock_test_and_set(value, newValue);
+#endif
+}
+
+//=========================================================//
+
+// returns the current pointer
+inline void* atomicLoadPointer(void* volatile* pointer)
+{
+#if defined(_WIN32)
+	return InterlockedCompareExchangePointer(pointer, NULL, NULL);
+#else
+	return __sync_val_compare_and_swap(pointer, (void*)NULL, (void*)NULL);
+#endif
+}
+
+//=========================================================//
+
+// replaces the pointer and returns the previous one
+inline void* atomicExchangePointer(void* volatile* pointer, void* newPointer)
+{
+#if defined(_WIN32)
+	return InterlockedExchangePointer(pointer, newPointer);
+#else
+	__sync_synchronize();
+	return __sync_lock_test_and_set(pointer, newPointer);
+#endif
+}
+
+//=========================================================//
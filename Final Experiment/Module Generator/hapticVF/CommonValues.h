@@ -45,53 +45,55 @@ public:
 	double					forceMax;
 	cWorld*					world;
 	cGeneric3dofPointer*	tool;	
+	cGenericObject*			fixtureRoot;		// parent of all the path fixtures
+	cGenericObject*			fixtureCollisionRoot;	// parent of the fixture meshes the proxy collides with
+	cWorld*					collisionWorld;		// the only nodes the proxy checks; drawn as part of world
+	SceneCommandQueue*		sceneCommands;		// scene changes from the haptic thread, applied by the graphics thread
+	SessionEventQueue*		sessionEvents;		// trial events from the haptic thread, handled by the session service
+	PathProgress*			pathProgress;		// progress along the attached path, haptic thread only; NULL if none
+	GuidanceVectorField*	guidanceField;		// guidance of the attached path, haptic thread only; NULL if none
 	Point*					createdPoints;
 	cMaterial				pinkBlank;
 	cMaterial				brownBlank;
 	cMaterial				magneticSphereMat;
 	double					stdBlockRadius;
 	double					stdBlockHeight;
-	int						vertexIndex[6][21]; //face, vertex number
 	int						numOfCollisions;
 	double					forceScaleFactor;
+	GuidanceForceLaw*		guidanceForceLaw;	// sampled into the force profiles of the segments
 	double					defaultTransparencyLevel;
 	bool					isInsideThePath;
-	time_t					startingTime;
-	time_t					endingTime;
-	double					totalTime1;
-	double					totalTime2;
-	double					totalTime3;
-	double					averageTime;
-	double					startingNumCollisions;
-	double					endingNumCollisions;
-	double					totalNumCollisions1;
-	double					totalNumCollisions2;
-	double					totalNumCollisions3;
-	double					averageTotalNumCollisions;
-	ofstream				outfileForces;
-	ofstream				outfileCollisionTime;
+	long long				hapticTime;			// monotonic time of the current haptic tick [ns]
 	double					numOfMidPoints;
 	cShapeSphere*			toolTipEndSphere;
 	cMatrix3d				toolTipOriginalOrientation;
 	double					cameraAngleH;
 	double					cameraAngleV;
 	double					cameraDistance; 
-	bool					hasModuleEnded;
 	bool					isTutorialModule;
+	double					targetFrameRate;	// graphics frame rate, 0 = unlimited
 	
 	//========================[EXPERIMENT'S VARIABLES]=========//
 	bool					V;
 	bool					F;
 	bool					G;
 	int						trials;
+	int						numOfTrials;		// timed trials per module
+	bool					areFixtureWallsEnabled;	// the walls of the blocks and corners push back (with F)
+	bool					areAnatomyWallsEnabled;	// the surface of the model pushes back
+	bool					isAnatomyMeshCollisionEnabled;	// ... through proxy collisions with its triangles, not its distance field
+
+	int						anatomyFieldResolution;	// voxels along the longest side of the model
+	bool					isGuidanceFieldEnabled;	// the guidance (with G) is read from a baked field instead of the magnets
+	double					fixtureWindowLength;	// arc length of the path in the scene ahead of the tool [block heights]; 0 = all of it
+
 	string					moduleName;
+	string					pointsFileName;		// read by createPoints() in READ_FROM_FILE mode
 
 
 	//========================[CONSTANTS]======================//
-	static const double CORNER_SCALE_FACTOR;
 	static const double BLOCK_SCALE_FACTOR;
 	static const double BLOCK_RADIUS_SCALE_FACTOR;
-	static const double ROTATION_UNIT;
 
 
 	//========================[METHODS]========================//
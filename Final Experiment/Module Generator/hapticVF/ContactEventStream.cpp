@@ -0,0 +1,149 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Contact Event Stream]
+The contacts of the proxy, read once per haptic tick and compared with the
+contacts of the previous tick. Only the meshes a fixture has subscribed to
+are kept, and the fixture pipeline receives one event when the proxy starts
+touching such a mesh and one when it stops, instead of every fixture asking
+the tool about its own meshes in every tick.
+The proxy touches at most three objects at a time, so a tick costs the same
+whatever the number of fixtures in the path.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+ContactEventStream::ContactEventStream(void)
+{
+	subscriptions	= NULL;
+	numContacts		= 0;
+	numEvents		= 0;
+}
+
+//=========================================================//
+
+void ContactEventStream::setSubscriptions(const ContactSubscriptionMap* subscriptions)
+{
+	this->subscriptions	= subscriptions;
+	numContacts			= 0;
+	numEvents			= 0;
+}
+
+//=========================================================//
+
+void ContactEventStream::update(cGeneric3dofPointer* tool)
+{
+	numEvents = 0;
+	if(subscriptions == NULL)
+		return;
+
+	// the same points cGeneric3dofPointer::isInContact() looks at; a point is only
+	// valid while the ones before it are
+	cCollisionEvent* points[MAX_CONTACTS] =
+	{
+		tool->m_proxyPointForceModel->m_contactPoint0,
+		tool->m_proxyPointForceModel->m_contactPoint1,
+		tool->m_proxyPointForceModel->m_contactPoint2
+	};
+
+	cGenericObject*		current[MAX_CONTACTS];
+	ContactSubscription	currentSubscriptions[MAX_CONTACTS];
+	int					numCurrent = 0;
+
+	for(int i=0; i<MAX_CONTACTS; i++)
+	{
+		cGenericObject* object = points[i]->m_object;
+		if(object == NULL)
+			break;
+
+		bool isListed = false;
+		for(int j=0; j<numCurrent; j++)
+			if(current[j] == object)
+				isListed = true;
+		if(isListed)
+			continue;
+
+		ContactSubscriptionMap::const_iterator subscription = subscriptions->find(object);
+		if(subscription == subscriptions->end())
+			continue;
+
+		current[numCurrent]					= object;
+		currentSubscriptions[numCurrent]	= subscription->second;
+		numCurrent++;
+	}
+
+	// exits
+	for(int i=0; i<numContacts; i++)
+	{
+		bool isStillInContact = false;
+		for(int j=0; j<numCurrent; j++)
+			if(current[j] == contacts[i])
+				isStillInContact = true;
+
+		if(!isStillInContact)
+			addEvent(CONTACT_EXITED, contacts[i], contactSubscriptions[i]);
+	}
+
+	// entries
+	for(int i=0; i<numCurrent; i++)
+	{
+		bool wasInContact = false;
+		for(int j=0; j<numContacts; j++)
+			if(contacts[j] == current[i])
+				wasInContact = true;
+
+		if(!wasInContact)
+			addEvent(CONTACT_ENTERED, current[i], currentSubscriptions[i]);
+	}
+
+	for(int i=0; i<numCurrent; i++)
+	{
+		contacts[i]				= current[i];
+		contactSubscriptions[i]	= currentSubscriptions[i];
+	}
+	numContacts = numCurrent;
+}
+
+//=========================================================//
+
+void ContactEventStream::addEvent(ContactEventType type, cGenericObject* object, const ContactSubscription& subscription)
+{
+	events[numEvents].type			= type;
+	events[numEvents].object		= object;
+	events[numEvents].subscription	= subscription;
+	numEvents++;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+int ContactEventStream::getNumEvents(void)
+{
+	return numEvents;
+}
+
+//=========================================================//
+
+const ContactEvent& ContactEventStream::getEvent(int index)
+{
+	return events[index];
+}
+
+//=========================================================//
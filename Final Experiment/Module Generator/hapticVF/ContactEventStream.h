@@ -0,0 +1,97 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Contact Event Stream]
+The contacts of the proxy, read once per haptic tick and compared with the
+contacts of the previous tick. Only the meshes a fixture has subscribed to
+are kept, and the fixture pipeline receives one event when the proxy starts
+touching such a mesh and one when it stops, instead of every fixture asking
+the tool about its own meshes in every tick.
+The proxy touches at most three objects at a time, so a tick costs the same
+whatever the number of fixtures in the path.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+struct VFBlock;
+struct MagneticLine;
+
+enum ContactEventType
+{
+	CONTACT_ENTERED,
+	CONTACT_EXITED
+};
+
+enum ContactRole
+{
+	CONTACT_BLOCK_WALL,			// the cylinder of a block or corner
+	CONTACT_SEGMENT_TOP,		// the cap that turns the guidance of a line on
+	CONTACT_SEGMENT_BOTTOM		// the cap that turns it off
+};
+
+typedef struct ContactSubscription{
+
+public:
+	ContactRole		role;
+	VFBlock*		block;		// CONTACT_BLOCK_WALL
+	MagneticLine*	line;		// CONTACT_SEGMENT_*
+
+};
+
+typedef struct ContactEvent{
+
+public:
+	ContactEventType		type;
+	cGenericObject*			object;
+	ContactSubscription		subscription;
+
+};
+
+// the meshes of a fixture set, filled when the set is built
+typedef map<cGenericObject*, ContactSubscription> ContactSubscriptionMap;
+
+class ContactEventStream
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	static const int		MAX_CONTACTS = 3;		// contact points of the proxy solver
+
+	const ContactSubscriptionMap*	subscriptions;
+	cGenericObject*			contacts[MAX_CONTACTS];
+	ContactSubscription		contactSubscriptions[MAX_CONTACTS];
+	int						numContacts;
+	ContactEvent			events[2 * MAX_CONTACTS];
+	int						numEvents;
+
+	//========================[METHODS]========================//
+	void		addEvent(ContactEventType type, cGenericObject* object, const ContactSubscription& subscription);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor
+	ContactEventStream(void);
+	// the meshes to report; NULL reports nothing. The contacts of the previous set are forgotten
+	void		setSubscriptions(const ContactSubscriptionMap* subscriptions);
+	// reads the contacts of the proxy; call once per tick, after the interaction forces
+	void		update(cGeneric3dofPointer* tool);
+
+	//========================[METHODS]===setters & getters====//
+	// the events of the last update: the exits first, then the entries
+	int					getNumEvents(void);
+	const ContactEvent&	getEvent(int index);
+};
@@ -18,140 +18,65 @@ Qatar University
 
 #include "stdafx.h"
 
-
 /*=========================================================//
 //==================[METHODS DEFINITIONS]==================//
 //=========================================================*/
 
-Corner::Corner()
-{
-	redefineMeshes();
-	setupInitialMeshesProperties();
-	scaleRadius(values->BLOCK_RADIUS_SCALE_FACTOR);
-	measureInitialCylinderDimensions();
-	modifySize();
-
-	cylinder->setFrameSize(0.5, 0.2, true);
-	isCorner = true;
-
-}
-
-//=========================================================//
-
-void Corner::redefineMeshes(void)
-{	
-	string modelPath_body = "../resources/corner_noCovers.3DS";
-	string modelPath_top = "../resources/corner_top.3DS";
-	string modelPath_bottom = "../resources/corner_bottom.3DS";
-
-	bool fileload;
-	string resourceRoot;
-	
-	cylinder->deleteAllChildren();
-
-	fileload = cylinder->loadFromFile(RESOURCE_PATH(modelPath_body));
-	if (!fileload)
-	{
-		#if defined(_MSVC)
-		fileload = cylinder->loadFromFile(modelPath_body);
-		#endif
-	}
-	if (!fileload)
-	{
-		printf("Error - 3D Model [body] failed to load correctly.\n");
-	}
-
-	//===================================================
-
-	top->deleteAllChildren();
-
-	fileload = top->loadFromFile(RESOURCE_PATH(modelPath_top));
-	if (!fileload)
-	{
-		#if defined(_MSVC)
-		fileload = top->loadFromFile(modelPath_top);
-		#endif
-	}
-	if (!fileload)
-	{
-		printf("Error - 3D Model [top] failed to load correctly.\n");
-	}
-
-	//===================================================
-
-	bottom->deleteAllChildren();
-
-	fileload = bottom->loadFromFile(RESOURCE_PATH(modelPath_bottom));
-	if (!fileload)
-	{
-		#if defined(_MSVC)
-		fileload = bottom->loadFromFile(modelPath_bottom);
-		#endif
-	}
-	if (!fileload)
-	{
-		printf("Error - 3D Model [bottom] failed to load correctly.\n");
-	}
-}
-
-//=========================================================//
-
-void Corner::modifySize(void)
+Corner::Corner(double bendAngle, double blockRadius) : VFBlock(false)
 {
-	cylinder->scale(values->CORNER_SCALE_FACTOR);
-	top->scale(values->CORNER_SCALE_FACTOR);
-	bottom->scale(values->CORNER_SCALE_FACTOR);	
+	const CornerShape* shape = CornerGeometry::getShape(bendAngle, blockRadius);
 
-	scale(values->BLOCK_SCALE_FACTOR);
-}
+	cylinder	= CornerGeometry::createMesh(values->world, shape, CORNER_BODY);
+	top			= CornerGeometry::createMesh(values->world, shape, CORNER_TOP);
+	bottom		= CornerGeometry::createMesh(values->world, shape, CORNER_BOTTOM);
 
-//=========================================================//
+	topSidePos		= shape->topSide;
+	topCenterPos	= shape->topCenter;
+	bottomCenterPos	= shape->bottomCenter;
+	bottomSidePos	= shape->bottomSide;
+	height			= shape->height;
+	radius			= shape->radius;
 
-void Corner::setVertexPos(int faceNum, int vertexNum, cVector3d pos)
-{
-	cylinder->pVerticesNonEmpty()->at(values->vertexIndex[faceNum][vertexNum]).setPos(pos);
-}
+	// the meshes are generated at their size, and share the trees of their shape
+	collisionName	= shape->name;
+	isCorner		= true;
 
-//=========================================================//
+	setupMeshesAppearance();
+	updateCollisionDetectors();
 
-cVector3d Corner::getVertexPos(int faceNum, int vertexNum)
-{
-	cylinder->computeGlobalPositions();
-	return cylinder->pVerticesNonEmpty()->at(values->vertexIndex[faceNum][vertexNum]).getPos();
-}
+	// add to the collision node of the fixtures, as the blocks are
+	values->fixtureCollisionRoot->addChild(cylinder);
+	values->fixtureCollisionRoot->addChild(top);
+	values->fixtureCollisionRoot->addChild(bottom);
 
-//=========================================================//
+	cylinder->setFrameSize(0.5, 0.2, true);
 
-void Corner::translateVertex(int faceNum, int vertexNum, cVector3d tran)
-{
-	cylinder->pVerticesNonEmpty()->at(values->vertexIndex[faceNum][vertexNum]).translate(tran);
 }
 
 //=========================================================//
 
-void Corner::recalculateCollision(void)
+void Corner::place(cVector3d entryCenter, cVector3d entryDirection, cVector3d exitDirection)
 {
-	cylinder->createAABBCollisionDetector(values->proxyRadius, true, true);
-	cylinder->computeAllNormals(true);
-	cylinder->computeBoundaryBox(true);
-
-	top->createAABBCollisionDetector(values->proxyRadius, true, true);
-	top->computeAllNormals(true);
-	top->computeBoundaryBox(true);
+	cVector3d along = cNormalize(entryDirection);
 
-	bottom->createAABBCollisionDetector(values->proxyRadius, true, true);
-	bottom->computeAllNormals(true);
-	bottom->computeBoundaryBox(true);
-}
+	// the shape turns towards its y axis: the part of the exit direction across the entry one
+	cVector3d inside = cSub(exitDirection, cMul(cDot(exitDirection, along), along));
+	if(inside.lengthsq() < CHAI_SMALL)
+	{
+		// no bend, any direction across will do
+		inside = cCross(along, cVector3d(1,0,0));
+		if(inside.lengthsq() < CHAI_SMALL)
+			inside = cCross(along, cVector3d(0,1,0));
+	}
+	inside.normalize();
 
-//=========================================================//
+	cMatrix3d frame;
+	frame.setCol(cCross(inside, along), inside, along);
 
-void Corner::rotateBottom(cVector3d rotAxis, double rotAngleDegrees)
-{
-	bottom->rotate(rotAxis, cDegToRad(rotAngleDegrees));
-	bottomCenterSphere->rotate(rotAxis, cDegToRad(rotAngleDegrees));
-	bottomSideSphere->rotate(rotAxis, cDegToRad(rotAngleDegrees));
+	cylinder->setRot(frame);
+	top->setRot(frame);
+	bottom->setRot(frame);
+	setPos(entryCenter);
 }
 
 //=========================================================//
-
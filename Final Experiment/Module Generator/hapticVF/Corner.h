@@ -27,10 +27,6 @@ protected:
 	//========================[VARIABLES]======================//
 
 	//========================[METHODS]========================//
-	// loads the meshes specific to the corner shape
-	void		redefineMeshes(void);
-	// adjusts the size of the corner to match the cylinder's proportions
-	void		modifySize(void);
 
 
 /*=========================================================//
@@ -41,12 +37,12 @@ public:
 	Corner* next;
 
 	//========================[METHODS]========================//
-	Corner();
-	void		setVertexPos(int faceNum, int vertexNum, cVector3d pos);
-	cVector3d	getVertexPos(int faceNum, int vertexNum);
-	void		translateVertex(int faceNum, int vertexNum, cVector3d tran);
-	void		recalculateCollision();
-	void		rotateBottom(cVector3d rotAxis, double rotAngleDegrees);
+	// a corner turning by the bend angle, in degrees, with the given radius; its meshes are those
+	// of the shape of its bend (see CornerGeometry)
+	Corner(double bendAngle, double blockRadius);
+	// places the top of the corner at the center of the end of a block, along the direction of
+	// the block, and turns it towards the direction of the next one
+	void		place(cVector3d entryCenter, cVector3d entryDirection, cVector3d exitDirection);
 
 
 /*=========================================================//
@@ -0,0 +1,205 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Corner Geometry]
+Generates the meshes of the corners. A corner is the section of a torus
+swept by the cross-section of the blocks about the bend of the path, its
+axis turning by the bend angle about a center one radius away, which is
+where the blocks on both sides of the bend are trimmed to. The shapes are
+kept per bend angle and radius, both quantized, so that the corners of
+the same bend share their vertices and, under the name of the shape,
+their collision trees (see MeshCollisionBVH).
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+static const double	CORNER_ANGLE_STEP	= 0.5;		// degrees between the cached bends
+static const double	CORNER_RADIUS_STEP	= 1.005;	// ratio between the cached radii
+static const int	CORNER_NUM_SIDES	= 20;		// of the cross-section, as the blocks
+static const double	CORNER_SWEEP_STEP	= 7.5;		// degrees of the bend between two rings at most
+
+map<pair<int, int>, CornerShape*> CornerGeometry::shapes;
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+const CornerShape* CornerGeometry::getShape(double bendAngle, double radius)
+{
+	int angleKey	= cMax(0, (int)floor(bendAngle / CORNER_ANGLE_STEP + 0.5));
+	int radiusKey	= (int)floor(log(radius) / log(CORNER_RADIUS_STEP) + 0.5);
+
+	CornerShape*& shape = shapes[make_pair(angleKey, radiusKey)];
+	if(shape == NULL)
+	{
+		shape = new CornerShape();
+		shape->bendAngle	= angleKey * CORNER_ANGLE_STEP;
+		shape->radius		= pow(CORNER_RADIUS_STEP, radiusKey);
+
+		ostringstream name;
+		name << "corner " << angleKey << " " << radiusKey;
+		shape->name = name.str();
+
+		build(shape);
+	}
+
+	return shape;
+}
+
+//=========================================================//
+
+void CornerGeometry::build(CornerShape* shape)
+{
+	double	angle		= cDegToRad(shape->bendAngle);
+	double	r			= shape->radius;
+	int		numRings	= cMax(1, (int)ceil(shape->bendAngle / CORNER_SWEEP_STEP)) + 1;
+
+	// the axis bends about (0, r, 0), so the inner side of the wall pinches there
+	vector<cVector3d>& positions	= shape->positions[CORNER_BODY];
+	vector<cVector3d>& normals		= shape->normals[CORNER_BODY];
+	positions.reserve(numRings * CORNER_NUM_SIDES);
+	normals.reserve(numRings * CORNER_NUM_SIDES);
+
+	for(int i=0; i<numRings; i++)
+	{
+		double		sweep	= angle * i / (numRings - 1);
+		cVector3d	center(0, r - r * cos(sweep), r * sin(sweep));
+		cVector3d	outward(0, -cos(sweep), sin(sweep));
+
+		for(int j=0; j<CORNER_NUM_SIDES; j++)
+		{
+			double		side	= 2.0 * CHAI_PI * j / CORNER_NUM_SIDES;
+			cVector3d	normal	= cAdd(cMul(cos(side), outward), cVector3d(sin(side), 0, 0));
+			positions.push_back(cAdd(center, cMul(r, normal)));
+			normals.push_back(normal);
+		}
+	}
+
+	vector<int>& triangles = shape->triangles[CORNER_BODY];
+	triangles.reserve(6 * (numRings - 1) * CORNER_NUM_SIDES);
+	for(int i=0; i<numRings - 1; i++)
+	{
+		for(int j=0; j<CORNER_NUM_SIDES; j++)
+		{
+			int a = i * CORNER_NUM_SIDES + j;
+			int b = i * CORNER_NUM_SIDES + (j + 1) % CORNER_NUM_SIDES;
+			int c = b + CORNER_NUM_SIDES;
+			int d = a + CORNER_NUM_SIDES;
+
+			addTriangle(shape, CORNER_BODY, a, b, c);
+			addTriangle(shape, CORNER_BODY, a, c, d);
+		}
+	}
+
+	cVector3d exitCenter(0, r - r * cos(angle), r * sin(angle));
+	cVector3d exitOutward(0, -cos(angle), sin(angle));
+	buildCap(shape, CORNER_TOP, cVector3d(0, 0, 0), cVector3d(0, -1, 0), cVector3d(0, 0, -1));
+	buildCap(shape, CORNER_BOTTOM, exitCenter, exitOutward, cVector3d(0, sin(angle), cos(angle)));
+
+	shape->topCenter	= shape->positions[CORNER_TOP][0];
+	shape->topSide		= shape->positions[CORNER_TOP][1];
+	shape->bottomCenter	= shape->positions[CORNER_BOTTOM][0];
+	shape->bottomSide	= shape->positions[CORNER_BOTTOM][1];
+	shape->height		= cDistance(shape->topCenter, shape->bottomCenter);
+}
+
+//=========================================================//
+
+void CornerGeometry::addTriangle(CornerShape* shape, CornerPart part, int a, int b, int c)
+{
+	// the rings all meet at the center of the bend; the triangles there have no area
+	const vector<cVector3d>& positions = shape->positions[part];
+	cVector3d normal = cCross(cSub(positions[b], positions[a]), cSub(positions[c], positions[a]));
+	if(cDot(normal, normal) < CHAI_SMALL * shape->radius * shape->radius * shape->radius * shape->radius)
+		return;
+
+	shape->triangles[part].push_back(a);
+	shape->triangles[part].push_back(b);
+	shape->triangles[part].push_back(c);
+}
+
+//=========================================================//
+
+void CornerGeometry::buildCap(CornerShape* shape, CornerPart part, cVector3d center, cVector3d outward,
+							  cVector3d normal)
+{
+	double r = shape->radius;
+
+	vector<cVector3d>& positions	= shape->positions[part];
+	vector<cVector3d>& normals		= shape->normals[part];
+	positions.push_back(center);
+	normals.push_back(normal);
+
+	// the rim goes round as the rings of the wall do
+	for(int j=0; j<CORNER_NUM_SIDES; j++)
+	{
+		double side = 2.0 * CHAI_PI * j / CORNER_NUM_SIDES;
+		positions.push_back(cAdd(center, cAdd(cMul(r * cos(side), outward), cVector3d(r * sin(side), 0, 0))));
+		normals.push_back(normal);
+	}
+
+	// wound to face along the normal
+	bool isReversed = cDot(cCross(outward, cVector3d(1, 0, 0)), normal) < 0;
+
+	vector<int>& triangles = shape->triangles[part];
+	for(int j=0; j<CORNER_NUM_SIDES; j++)
+	{
+		int a = 1 + j;
+		int b = 1 + (j + 1) % CORNER_NUM_SIDES;
+		triangles.push_back(0);
+		triangles.push_back(isReversed ? b : a);
+		triangles.push_back(isReversed ? a : b);
+	}
+}
+
+//=========================================================//
+
+cMesh* CornerGeometry::createMesh(cWorld* world, const CornerShape* shape, CornerPart part)
+{
+	// the contacts and the shared trees are those of the child mesh
+	cMesh* mesh = new cMesh(world);
+	cMesh* child = new cMesh(world);
+	mesh->addChild(child);
+
+	const vector<cVector3d>&	positions	= shape->positions[part];
+	const vector<cVector3d>&	normals		= shape->normals[part];
+	const vector<int>&			triangles	= shape->triangles[part];
+
+	child->pVertices()->reserve(positions.size());
+	for(unsigned int i=0; i<positions.size(); i++)
+	{
+		unsigned int v = child->newVertex(positions[i]);
+		(*child->pVertices())[v].setNormal(normals[i]);
+	}
+
+	child->pTriangles()->reserve(triangles.size() / 3);
+	for(unsigned int i=0; i<triangles.size(); i+=3)
+		child->newTriangle(triangles[i], triangles[i+1], triangles[i+2]);
+
+	mesh->computeBoundaryBox(true);
+
+	return mesh;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+int CornerGeometry::getNumShapes(void)
+{
+	return (int)shapes.size();
+}
+
+//=========================================================//
@@ -0,0 +1,85 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Corner Geometry]
+Generates the meshes of the corners. A corner is the section of a torus
+swept by the cross-section of the blocks about the bend of the path, its
+axis turning by the bend angle about a center one radius away, which is
+where the blocks on both sides of the bend are trimmed to. The shapes are
+kept per bend angle and radius, both quantized, so that the corners of
+the same bend share their vertices and, under the name of the shape,
+their collision trees (see MeshCollisionBVH).
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+enum CornerPart
+{
+	CORNER_BODY,		// the wall, open at both ends
+	CORNER_TOP,			// the cap where the path comes in
+	CORNER_BOTTOM,		// the cap where it leaves
+	CORNER_NUM_PARTS
+};
+
+// the geometry of the corners of one bend, in the frame of a corner: the path comes in at the
+// origin along z and turns towards y, about the x axis
+typedef struct CornerShape{
+
+public:
+	vector<cVector3d>	positions[CORNER_NUM_PARTS];
+	vector<cVector3d>	normals[CORNER_NUM_PARTS];
+	vector<int>			triangles[CORNER_NUM_PARTS];	// three vertices each
+	double				bendAngle;						// quantized, in degrees
+	double				radius;							// quantized
+	double				height;							// between the centers of the caps
+
+	// the marks of the block (see VFBlock): vertices 0 and 1 of the caps
+	cVector3d			topCenter;
+	cVector3d			topSide;
+	cVector3d			bottomCenter;
+	cVector3d			bottomSide;
+
+	string				name;							// of its collision trees
+
+};
+
+class CornerGeometry
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	static map<pair<int, int>, CornerShape*>	shapes;	// per quantized angle and radius; kept for good
+
+	//========================[METHODS]========================//
+	// sweeps the cross-section of the shape about its bend
+	static void		build(CornerShape* shape);
+	// unless it has no area
+	static void		addTriangle(CornerShape* shape, CornerPart part, int a, int b, int c);
+	// a disk closing the wall, facing along the normal: its center, then its rim
+	static void		buildCap(CornerShape* shape, CornerPart part, cVector3d center, cVector3d outward,
+							 cVector3d normal);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]=====build thread=======//
+	// the shape of the corners turning by the bend angle, in degrees, with the given radius
+	static const CornerShape*	getShape(double bendAngle, double radius);
+	// a mesh holding one part of the shape in a child mesh, as the meshes loaded from files do
+	static cMesh*				createMesh(cWorld* world, const CornerShape* shape, CornerPart part);
+
+	//========================[METHODS]===setters & getters====//
+	static int					getNumShapes(void);
+};
@@ -0,0 +1,75 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Fixture Pipeline]
+The per-tick evaluation of the path fixtures, specialized for the feedback
+that changes in every tick: the highlight of the blocks (V) and the magnets
+of the lines (G) are compiled out of the pipelines of the modules without
+them, and the haptic loop picks the pipeline of the running module through a
+single function pointer instead of testing the flags in every line. The
+stiffness of the walls (F) is set once, when the path is built.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+template<class Policy>
+void FixturePipeline<Policy>::updateHaptics(ContactEventStream* contacts, vector<MagneticLine*>& activeLines)
+{
+	// the forces are sent to the device once per tick, by the haptic loop
+
+	for(int i=0; i<contacts->getNumEvents(); i++)
+	{
+		const ContactEvent& event = contacts->getEvent(i);
+		MagneticLine* line = event.subscription.line;
+
+		switch(event.subscription.role)
+		{
+			case CONTACT_BLOCK_WALL:
+				event.subscription.block->onWallContact(event.type);
+				break;
+			case CONTACT_SEGMENT_TOP:
+				if(event.type == CONTACT_ENTERED && line->onTopContact<Policy>())
+					activeLines.push_back(line);
+				break;
+			case CONTACT_SEGMENT_BOTTOM:
+				if(event.type == CONTACT_ENTERED && line->onBottomContact<Policy>())
+					activeLines.erase(find(activeLines.begin(), activeLines.end(), line));
+				break;
+		}
+	}
+
+	// the peak force of the segments is recorded with or without guidance
+	for(unsigned int i=0; i<activeLines.size(); i++)
+		activeLines[i]->updateHaptics();
+}
+
+//=========================================================//
+
+FixturePipelineFunction getFixturePipeline(bool V, bool G)
+{
+	// indexed by the flags as the bits VG
+	static const FixturePipelineFunction pipelines[4] =
+	{
+		FixturePipeline<NoFeedbackPolicy>::updateHaptics,
+		FixturePipeline<GuidancePolicy>::updateHaptics,
+		FixturePipeline<VPolicy>::updateHaptics,
+		FixturePipeline<GVPolicy>::updateHaptics
+	};
+
+	return pipelines[(V ? 2 : 0) + (G ? 1 : 0)];
+}
+
+//=========================================================//
@@ -0,0 +1,58 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Fixture Pipeline]
+The per-tick evaluation of the path fixtures, specialized for the feedback
+that changes in every tick: the highlight of the blocks (V) and the magnets
+of the lines (G) are compiled out of the pipelines of the modules without
+them, and the haptic loop picks the pipeline of the running module through a
+single function pointer instead of testing the flags in every line. The
+stiffness of the walls (F) is set once, when the path is built.
+The fixtures are driven by the contact events of the tick (see
+ContactEventStream); only the lines whose guidance is on are visited in
+every tick.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+template<bool V, bool G>
+struct FeedbackPolicy{
+
+public:
+	static const bool visual			= V;	// highlighted blocks
+	static const bool guidance			= G;	// magnetic lines
+
+};
+
+// V and FV run the visual pipeline, FG the guidance one, GV and COM both
+typedef FeedbackPolicy<false, false>	NoFeedbackPolicy;
+typedef FeedbackPolicy<true,  false>	VPolicy;
+typedef FeedbackPolicy<false, true >	GuidancePolicy;
+typedef FeedbackPolicy<true,  true >	GVPolicy;
+
+// updates the fixtures of a path for one haptic tick; activeLines holds the lines
+// whose guidance is on and is kept up to date by the pipeline
+typedef void (*FixturePipelineFunction)(ContactEventStream* contacts, vector<MagneticLine*>& activeLines);
+
+template<class Policy>
+class FixturePipeline
+{
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	static void		updateHaptics(ContactEventStream* contacts, vector<MagneticLine*>& activeLines);
+};
+
+// returns the pipeline of a feedback configuration (F does not change it)
+FixturePipelineFunction	getFixturePipeline(bool V, bool G);
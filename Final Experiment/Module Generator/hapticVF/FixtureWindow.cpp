@@ -0,0 +1,451 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Fixture Window]
+Keeps only the fixtures near the tool in the scene. The fixtures of a path
+are built in one group per segment, under nodes of their own; when streaming,
+only the groups within an arc length of the segment of the tool are enabled,
+so the haptic loop only checks the walls of a few segments whatever the
+length of the path.
+The groups ahead of the window get their collision detectors back on a
+worker thread before the tool reaches them; the groups left behind lose
+theirs once the graphics thread is done drawing them. The window is moved by
+the haptic thread, only when the tool changes segment, by switching the nodes
+of the groups on and off; the structure of the scene graph does not change,
+so the haptic loop never has to wait for the graphics thread.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+// of the length of the window ahead of the tool
+static const double	WINDOW_BEHIND_FRACTION		= 0.5;
+static const double	WINDOW_PREFETCH_FRACTION	= 0.5;
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================FIXTURE GROUP NODE=====================//
+//=========================================================*/
+
+FixtureGroupNode::FixtureGroupNode(void)
+{
+	isEnabled = 1;
+}
+
+//=========================================================//
+
+void FixtureGroupNode::renderSceneGraph(const int a_renderMode)
+{
+	if(atomicLoad(&isEnabled))
+		cGenericObject::renderSceneGraph(a_renderMode);
+}
+
+//=========================================================//
+
+bool FixtureGroupNode::computeCollisionDetection(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+												 cCollisionRecorder& a_recorder, cCollisionSettings& a_settings)
+{
+	if(!atomicLoad(&isEnabled))
+		return false;
+
+	return cGenericObject::computeCollisionDetection(a_segmentPointA, a_segmentPointB, a_recorder, a_settings);
+}
+
+//=========================================================//
+
+cVector3d FixtureGroupNode::computeInteractions(const cVector3d& a_toolPos, const cVector3d& a_toolVel,
+												const unsigned int a_IDN, cInteractionRecorder& a_interactions)
+{
+	// the magnets of the lines of a disabled group are not even visited
+	if(!atomicLoad(&isEnabled))
+		return cVector3d(0, 0, 0);
+
+	return cGenericObject::computeInteractions(a_toolPos, a_toolVel, a_IDN, a_interactions);
+}
+
+//=========================================================//
+
+void FixtureGroupNode::setEnabled(bool status)
+{
+	atomicStore(&isEnabled, status ? 1 : 0);
+}
+
+//=========================================================//
+
+bool FixtureGroupNode::getEnabled(void)
+{
+	return atomicLoad(&isEnabled) != 0;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================FIXTURE WINDOW=========================//
+//=========================================================*/
+
+FixtureWindow::FixtureWindow(void)
+{
+	root				= NULL;
+	collisionRoot		= NULL;
+	isStreaming			= false;
+	ahead				= 0;
+	behind				= 0;
+	prefetch			= 0;
+	segment				= 0;
+	first				= 0;
+	last				= -1;
+	lastPrefetched		= -1;
+	isWaiting			= false;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+}
+
+//=========================================================//
+
+FixtureWindow::~FixtureWindow(void)
+{
+	release();
+}
+
+//=========================================================//
+
+void FixtureWindow::createGroups(PathProgress* progress, cGenericObject* root, cGenericObject* collisionRoot)
+{
+	this->root			= root;
+	this->collisionRoot	= collisionRoot;
+
+	for(int i=0; i<progress->getNumSegments(); i++)
+	{
+		FixtureGroup* group = new FixtureGroup();
+		group->root					= new FixtureGroupNode();
+		group->collisionRoot		= new FixtureGroupNode();
+		group->index				= i;
+		group->arcStart				= progress->getSegmentArcLength(i);
+		group->arcEnd				= group->arcStart + progress->getSegmentLength(i);
+		group->numCollisionNodes	= 1;
+		group->numCollisionMeshes	= 0;
+		group->state				= FIXTURE_GROUP_READY;
+		groups.push_back(group);
+	}
+}
+
+//=========================================================//
+
+void FixtureWindow::materialize(bool isStreaming, double windowLength)
+{
+	this->isStreaming	= isStreaming && windowLength > 0;
+	ahead				= windowLength;
+	behind				= WINDOW_BEHIND_FRACTION * windowLength;
+	prefetch			= WINDOW_PREFETCH_FRACTION * windowLength;
+	segment				= 0;
+	isWaiting			= false;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+
+	if(groups.empty())
+		return;
+
+	if(this->isStreaming)
+	{
+		getRange(segment, ahead, behind, first, last);
+		getRange(segment, ahead + prefetch, behind, first, lastPrefetched);
+	}
+	else
+	{
+		first			= 0;
+		last			= (int)groups.size() - 1;
+		lastPrefetched	= last;
+	}
+
+	// the set is not in the world yet, so its nodes can be changed directly; every group stays
+	// under them from now on, only enabled or not
+	for(int i=0; i<(int)groups.size(); i++)
+	{
+		FixtureGroup* group = groups[i];
+		root->addChild(group->root);
+		collisionRoot->addChild(group->collisionRoot);
+
+		bool isInWindow = (i >= first && i <= last);
+		group->root->setEnabled(isInWindow);
+		group->collisionRoot->setEnabled(isInWindow);
+
+		if(isInWindow)
+		{
+			numCollisionNodes	+= group->numCollisionNodes;
+			numCollisionMeshes	+= group->numCollisionMeshes;
+			group->state = FIXTURE_GROUP_ATTACHED;
+		}
+		else if(i <= lastPrefetched)
+			group->state = FIXTURE_GROUP_READY;
+		else
+		{
+			for(unsigned int j=0; j<group->blocks.size(); j++)
+				group->blocks[j]->releaseCollisionDetectors();
+			group->state = FIXTURE_GROUP_RELEASED;
+		}
+	}
+
+	// no allocation once the haptic loop moves the window
+	strayed.reserve(groups.size());
+}
+
+//=========================================================//
+
+void FixtureWindow::release(void)
+{
+	// a worker may still be building or deleting the detectors of a group
+	WorkerPool::getInstance()->wait(&workers);
+
+	for(unsigned int i=0; i<groups.size(); i++)
+	{
+		FixtureGroup* group = groups[i];
+		if(root != NULL)
+			root->removeChild(group->root);
+		if(collisionRoot != NULL)
+			collisionRoot->removeChild(group->collisionRoot);
+		delete group->root;
+		delete group->collisionRoot;
+		delete group;
+	}
+
+	vector<FixtureGroup*>().swap(groups);
+	vector<FixtureGroup*>().swap(strayed);
+	root				= NULL;
+	collisionRoot		= NULL;
+	isStreaming			= false;
+	segment				= 0;
+	first				= 0;
+	last				= -1;
+	lastPrefetched		= -1;
+	isWaiting			= false;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+}
+
+//=========================================================//
+
+void FixtureWindow::getRange(int index, double aheadLength, double behindLength, int& first, int& last)
+{
+	first	= index;
+	last	= index;
+
+	while(first > 0 && groups[first - 1]->arcEnd >= groups[index]->arcStart - behindLength)
+		first--;
+	while(last < (int)groups.size() - 1 && groups[last + 1]->arcStart <= groups[index]->arcEnd + aheadLength)
+		last++;
+}
+
+//=========================================================//
+
+bool FixtureWindow::update(int toolSegment, SceneCommandQueue* commands)
+{
+	if(!isStreaming || groups.empty())
+		return false;
+
+	// released once their detectors are built, unless the window has come back to them
+	for(unsigned int i=0; i<strayed.size(); )
+	{
+		int index	= strayed[i]->index;
+		long state	= atomicLoad(&strayed[i]->state);
+
+		if(state == FIXTURE_GROUP_PREFETCHING)
+		{
+			i++;
+			continue;
+		}
+
+		if(state == FIXTURE_GROUP_READY && (index < first || index > lastPrefetched))
+		{
+			atomicStore(&strayed[i]->state, FIXTURE_GROUP_RECYCLING);
+			if(!commands->submitTask(recycleTask, strayed[i], &workers))
+			{
+				// the queue is full; tried again at the next tick
+				atomicStore(&strayed[i]->state, FIXTURE_GROUP_READY);
+				i++;
+				continue;
+			}
+		}
+		strayed[i] = strayed.back();
+		strayed.pop_back();
+	}
+
+	toolSegment = cClamp(toolSegment, 0, (int)groups.size() - 1);
+	if(toolSegment == segment && !isWaiting)
+		return false;
+
+	int newFirst, newLast, newLastPrefetched;
+	getRange(toolSegment, ahead, behind, newFirst, newLast);
+	getRange(toolSegment, ahead + prefetch, behind, newFirst, newLastPrefetched);
+
+	// out of the window: disabled, and released unless the tool is heading for them
+	bool isChanged = false;
+	for(int i=first; i<=lastPrefetched; i++)
+	{
+		if(i >= newFirst && i <= newLast)
+			continue;
+
+		FixtureGroup* group	= groups[i];
+		bool isPrefetched	= (i >= newFirst && i <= newLastPrefetched);
+		long state			= atomicLoad(&group->state);
+		if(state == FIXTURE_GROUP_ATTACHED)
+		{
+			detach(group);
+			isChanged = true;
+			if(!isPrefetched)
+				recycle(group, commands);
+		}
+		else if(state == FIXTURE_GROUP_READY && !isPrefetched)
+			recycle(group, commands);
+		else if(state == FIXTURE_GROUP_PREFETCHING && !isPrefetched)
+			strayed.push_back(group);
+
+	}
+
+	// into the window: enabled once their detectors are built
+	isWaiting = false;
+	for(int i=newFirst; i<=newLastPrefetched; i++)
+	{
+		FixtureGroup* group	= groups[i];
+		long state			= atomicLoad(&group->state);
+		if(state == FIXTURE_GROUP_RELEASED)
+		{
+			// if the queue is full, the group is tried again at the next tick
+			atomicStore(&group->state, FIXTURE_GROUP_PREFETCHING);
+			if(commands->submitTask(prefetchTask, group, &workers))
+				state = FIXTURE_GROUP_PREFETCHING;
+			else
+			{
+				atomicStore(&group->state, FIXTURE_GROUP_RELEASED);
+				isWaiting = true;
+			}
+		}
+
+		if(i > newLast || state == FIXTURE_GROUP_ATTACHED)
+			continue;
+
+		if(state == FIXTURE_GROUP_READY)
+		{
+			attach(group);
+			isChanged = true;
+		}
+		else
+			isWaiting = true;
+	}
+
+	segment			= toolSegment;
+	first			= newFirst;
+	last			= newLast;
+	lastPrefetched	= newLastPrefetched;
+
+	return isChanged;
+}
+
+//=========================================================//
+
+void FixtureWindow::attach(FixtureGroup* group)
+{
+	group->root->setEnabled(true);
+	group->collisionRoot->setEnabled(true);
+	numCollisionNodes	+= group->numCollisionNodes;
+	numCollisionMeshes	+= group->numCollisionMeshes;
+	atomicStore(&group->state, FIXTURE_GROUP_ATTACHED);
+}
+
+//=========================================================//
+
+void FixtureWindow::detach(FixtureGroup* group)
+{
+	// the haptic thread itself no longer reaches into the meshes from the next query on
+	group->root->setEnabled(false);
+	group->collisionRoot->setEnabled(false);
+	numCollisionNodes	-= group->numCollisionNodes;
+	numCollisionMeshes	-= group->numCollisionMeshes;
+	atomicStore(&group->state, FIXTURE_GROUP_READY);
+}
+
+//=========================================================//
+
+void FixtureWindow::recycle(FixtureGroup* group, SceneCommandQueue* commands)
+{
+	// the frame being drawn may still be in the meshes of the group; the task is handed to the
+	// pool at the start of the next one. If the queue is full, the group is tried again later
+	atomicStore(&group->state, FIXTURE_GROUP_RECYCLING);
+	if(!commands->submitTask(recycleTask, group, &workers))
+	{
+		atomicStore(&group->state, FIXTURE_GROUP_READY);
+		strayed.push_back(group);
+	}
+}
+
+//=========================================================//
+
+void FixtureWindow::prefetchTask(void* arg)
+{
+	FixtureGroup* group = (FixtureGroup*)arg;
+
+	for(unsigned int i=0; i<group->blocks.size(); i++)
+		group->blocks[i]->updateCollisionDetectors();
+
+	atomicStore(&group->state, FIXTURE_GROUP_READY);
+}
+
+//=========================================================//
+
+void FixtureWindow::recycleTask(void* arg)
+{
+	FixtureGroup* group = (FixtureGroup*)arg;
+
+	for(unsigned int i=0; i<group->blocks.size(); i++)
+		group->blocks[i]->releaseCollisionDetectors();
+
+	atomicStore(&group->state, FIXTURE_GROUP_RELEASED);
+}
+
+//=========================================================//
+
+int FixtureWindow::getNumGroups(void)
+{
+	return (int)groups.size();
+}
+
+//=========================================================//
+
+FixtureGroup* FixtureWindow::getGroup(int index)
+{
+	if(index < 0 || index >= (int)groups.size())
+		return NULL;
+
+	return groups[index];
+}
+
+//=========================================================//
+
+bool FixtureWindow::getIsStreaming(void)
+{
+	return isStreaming;
+}
+
+//=========================================================//
+
+int FixtureWindow::getNumCollisionNodes(void)
+{
+	return numCollisionNodes;
+}
+
+//=========================================================//
+
+int FixtureWindow::getNumCollisionMeshes(void)
+{
+	return numCollisionMeshes;
+}
+
+//=========================================================//
@@ -0,0 +1,166 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Fixture Window]
+Keeps only the fixtures near the tool in the scene. The fixtures of a path
+are built in one group per segment, under nodes of their own; when streaming,
+only the groups within an arc length of the segment of the tool are enabled.
+A disabled group is skipped, with its children, by the collision detection
+and the force computation of the tool, and the haptic loop does not refresh
+the positions of the fixtures from tick to tick (they do not move), so the
+cost of a tick does not depend on the length of the path.
+The groups ahead of the window get their collision detectors back on a
+worker thread before the tool reaches them; the groups left behind lose
+theirs once the graphics thread is done drawing them. The window is moved by
+the haptic thread, only when the tool changes segment, by switching the nodes
+of the groups on and off; the structure of the scene graph does not change,
+so the haptic loop never has to wait for the graphics thread.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+enum FixtureGroupState
+{
+	FIXTURE_GROUP_RELEASED,		// out of the scene, without collision detectors
+	FIXTURE_GROUP_PREFETCHING,	// its detectors are being built by a worker
+	FIXTURE_GROUP_READY,		// out of the scene, with its detectors
+	FIXTURE_GROUP_ATTACHED,		// in the scene
+	FIXTURE_GROUP_RECYCLING		// its detectors are being deleted by a worker
+};
+
+// the node of a group; disabled, it stays in the scene graph but is neither drawn, nor checked for
+// collisions, nor asked for forces, with its children
+class FixtureGroupNode : public cGenericObject
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	volatile long	isEnabled;		// set by the haptic thread
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the node starts enabled
+	FixtureGroupNode(void);
+
+	virtual void	renderSceneGraph(const int a_renderMode = CHAI_RENDER_MODE_RENDER_ALL);
+	virtual bool	computeCollisionDetection(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+											  cCollisionRecorder& a_recorder, cCollisionSettings& a_settings);
+	virtual cVector3d	computeInteractions(const cVector3d& a_toolPos, const cVector3d& a_toolVel,
+											const unsigned int a_IDN, cInteractionRecorder& a_interactions);
+
+	//========================[METHODS]===setters & getters====//
+	void			setEnabled(bool status);
+	bool			getEnabled(void);
+};
+
+// the fixtures of one segment of the path
+typedef struct FixtureGroup{
+
+public:
+	FixtureGroupNode*	root;				// the shapes of its lines
+	FixtureGroupNode*	collisionRoot;		// the meshes of its block and of the corner at its end
+	vector<VFBlock*>	blocks;				// the block and the corner
+	int					index;				// of the segment
+
+	double				arcStart;			// arc length of the path at both ends of the segment
+	double				arcEnd;
+	int					numCollisionNodes;	// under collisionRoot, itself included
+	int					numCollisionMeshes;	// of which have a collision tree
+	volatile long		state;				// a FixtureGroupState; set by the worker once its job is done
+
+};
+
+class FixtureWindow
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<FixtureGroup*>	groups;			// one per segment, from the starting point
+	cGenericObject*			root;			// of the fixture set
+	cGenericObject*			collisionRoot;
+	bool					isStreaming;
+	double					ahead;			// arc length in the scene ahead of the segment of the tool
+	double					behind;			// ... and behind it
+	double					prefetch;		// beyond the window, arc length whose detectors are built in advance
+	WorkerGroup				workers;		// the prefetch and recycle tasks of the groups
+
+	// haptic thread only, once materialized
+	int						segment;		// of the tool at the last change
+	int						first;			// the groups in the scene
+	int						last;
+	int						lastPrefetched;	// the groups after last, up to this one, are kept ready
+	bool					isWaiting;		// a group of the window was not ready at the last change
+	vector<FixtureGroup*>	strayed;		// left the window while a worker was building their detectors,
+											// or could not be queued for recycling
+
+	int						numCollisionNodes;	// of the groups enabled
+	int						numCollisionMeshes;
+
+	//========================[METHODS]========================//
+	// not copyable, the groups are owned
+	FixtureWindow(const FixtureWindow&);
+	FixtureWindow& operator=(const FixtureWindow&);
+
+	// the groups within the arc lengths ahead of and behind a segment
+	void		getRange(int index, double aheadLength, double behindLength, int& first, int& last);
+	// enables or disables the nodes of the group
+	void		attach(FixtureGroup* group);
+	void		detach(FixtureGroup* group);
+	// queues the deletion of the detectors of a group out of the window; the graphics thread hands
+	// it to a worker after the current frame, once it can no longer be drawing the group
+	void		recycle(FixtureGroup* group, SceneCommandQueue* commands);
+
+	// worker tasks, on a FixtureGroup
+	static void	prefetchTask(void* group);
+	static void	recycleTask(void* group);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor
+	FixtureWindow(void);
+	// destructor; releases the groups
+	~FixtureWindow(void);
+
+	//========================[METHODS]=====build thread=======//
+	// one empty group per segment of the path; the fixtures are then built into their nodes
+	void			createGroups(PathProgress* progress, cGenericObject* root, cGenericObject* collisionRoot);
+	// puts the groups under the nodes of the set, enabling all of them, or when streaming only those
+	// around the starting point, in which case the groups far from it give up their collision detectors
+	void			materialize(bool isStreaming, double windowLength);
+	// once the set is out of the scene: waits for the workers, then deletes the groups with
+	// their nodes; the blocks themselves belong to the arena of the set (see PathArena). The
+	// queue is applied in order, so by then every task of the groups has reached the pool
+	void			release(void);
+
+	//========================[METHODS]=====haptic thread======//
+	// follows the tool to its segment; returns true if groups were enabled or disabled. The workers
+	// get their tasks through the queue, as the haptic thread does not lock
+	bool			update(int toolSegment, SceneCommandQueue* commands);
+
+	//========================[METHODS]===setters & getters====//
+	int				getNumGroups(void);
+	// the group of a segment, or NULL
+	FixtureGroup*	getGroup(int index);
+	bool			getIsStreaming(void);
+	int				getNumCollisionNodes(void);
+	int				getNumCollisionMeshes(void);
+};
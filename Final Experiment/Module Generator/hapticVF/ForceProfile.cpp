@@ -0,0 +1,101 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Force Profile]
+Lookup tables of the guidance forces of one segment of the path, filled when
+the path is built: the force of the line and of the end sphere by distance
+from the magnet, and the scale of both by how far along the segment the tool
+is. The magnet effects only interpolate them (see GatedMagnetEffect), so the
+force law can be swapped without touching the haptic loop and no material is
+rewritten while the tool moves.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+ForceLookupTable::ForceLookupTable(void)
+{
+	invStep = 0;
+}
+
+//=========================================================//
+
+void ForceLookupTable::resize(int numSamples, double range)
+{
+	samples.assign(numSamples, 0.0);
+
+	if(numSamples > 1 && range > 0)
+		invStep = (numSamples - 1) / range;
+	else
+		invStep = 0;
+}
+
+//=========================================================//
+
+void ForceLookupTable::build(GuidanceForceLaw* law, double maxForce, double maxDistance, double stiffness, int numSamples)
+{
+	resize(numSamples, maxDistance);
+
+	// the last sample is at maxDistance, where every law is zero
+	for(int i=0; i<numSamples; i++)
+	{
+		double distance = maxDistance * i / (numSamples - 1);
+		samples[i] = law->computeForce(distance, maxForce, maxDistance, stiffness);
+	}
+}
+
+//=========================================================//
+
+void ForceLookupTable::set(int index, double value)
+{
+	samples[index] = value;
+}
+
+//=========================================================//
+
+int ForceLookupTable::getNumSamples(void)
+{
+	return (int)samples.size();
+}
+
+//=========================================================//
+
+double ForceLookupTable::getValue(double x)
+{
+	int last = (int)samples.size() - 1;
+	if(last < 0)
+		return 0;
+
+	double position = x * invStep;
+	if(position <= 0)
+		return samples[0];
+	if(position >= last)
+		return samples[last];
+
+	int index = (int)position;
+	double t = position - index;
+	return samples[index] + t * (samples[index + 1] - samples[index]);
+}
+
+//=========================================================//
+
+SegmentForceProfile::SegmentForceProfile()
+{
+	invLength		= 0;
+	lineDamping		= 0;
+	sphereDamping	= 0;
+}
+
+//=========================================================//
@@ -0,0 +1,66 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Force Profile]
+Lookup tables of the guidance forces of one segment of the path, filled when
+the path is built: the force of the line and of the end sphere by distance
+from the magnet, and the scale of both by how far along the segment the tool
+is. The magnet effects only interpolate them (see GatedMagnetEffect), so the
+force law can be swapped without touching the haptic loop and no material is
+rewritten while the tool moves.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class ForceLookupTable
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<double>	samples;		// evenly spaced over [0, range]
+	double			invStep;
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; an empty table returns 0
+	ForceLookupTable(void);
+	// allocates the samples over [0, range]
+	void		resize(int numSamples, double range);
+	// samples a force law over [0, maxDistance]
+	void		build(GuidanceForceLaw* law, double maxForce, double maxDistance, double stiffness, int numSamples);
+	// sets the sample at index, i.e. at index * range / (numSamples - 1)
+	void		set(int index, double value);
+	int			getNumSamples(void);
+	// linear interpolation; clamped to the first and last samples
+	double		getValue(double x);
+};
+
+typedef struct SegmentForceProfile{
+
+public:
+	//========================[VARIABLES]======================//
+	ForceLookupTable	lineForce;			// by distance from the line
+	ForceLookupTable	sphereForce;		// by distance from the end sphere
+	ForceLookupTable	progressScale;		// by fraction of the segment travelled from A
+	double				invLength;			// 1 / length of the segment
+	double				lineDamping;
+	double				sphereDamping;
+
+	//========================[METHODS]========================//
+	SegmentForceProfile();
+
+};
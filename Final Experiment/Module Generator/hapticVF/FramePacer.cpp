@@ -0,0 +1,163 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Frame Pacer]
+Keeps the graphics loop at a target frame rate instead of redrawing as fast
+as possible, so that rendering does not compete with the haptic thread for
+CPU and memory bandwidth. Also collects frame-time statistics.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+FramePacer::FramePacer(double targetFrameRate)
+{
+	clock.reset();
+	clock.start();
+
+	setTargetFrameRate(targetFrameRate);
+	frameStartTime		= 0;
+	lastFrameStartTime	= -1;
+
+	resetStatistics();
+}
+
+//=========================================================//
+
+void FramePacer::beginFrame(void)
+{
+	frameStartTime = clock.getCurrentTimeSeconds();
+
+	if(lastFrameStartTime >= 0)
+	{
+		double frameTime = frameStartTime - lastFrameStartTime;
+		numFrames++;
+		sumFrameTime += frameTime;
+		if(frameTime < minFrameTime) minFrameTime = frameTime;
+		if(frameTime > maxFrameTime) maxFrameTime = frameTime;
+	}
+	else
+	{
+		// the deadlines count from the first frame, not from the startup before it
+		nextFrameTime = frameStartTime;
+	}
+	lastFrameStartTime = frameStartTime;
+}
+
+//=========================================================//
+
+void FramePacer::endFrame(void)
+{
+	double now = clock.getCurrentTimeSeconds();
+
+	double renderTime = now - frameStartTime;
+	sumRenderTime += renderTime;
+	if(renderTime > maxRenderTime) maxRenderTime = renderTime;
+
+	if(framePeriod <= 0)
+		return;
+
+	// deadlines advance by whole periods so that timer jitter does not accumulate
+	nextFrameTime += framePeriod;
+	if(nextFrameTime < now)
+	{
+		// missed the deadline; start again from now rather than bursting to catch up
+		numLateFrames++;
+		nextFrameTime = now;
+	}
+}
+
+//=========================================================//
+
+int FramePacer::getMillisecondsToNextFrame(void)
+{
+	if(framePeriod <= 0)
+		return 0;
+
+	double wait = nextFrameTime - clock.getCurrentTimeSeconds();
+	if(wait <= 0)
+		return 0;
+
+	return (int)(wait * 1000.0);
+}
+
+//=========================================================//
+
+void FramePacer::printStatistics(void)
+{
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	printf("Target frame rate: %1.1f fps\n", targetFrameRate);
+	if(numFrames > 0)
+	{
+		printf("Average frame rate: %1.1f fps over %ld frames\n", getAverageFrameRate(), numFrames);
+		printf("Frame time [ms]: avg %1.2f, min %1.2f, max %1.2f\n",
+			1000.0 * sumFrameTime / numFrames, 1000.0 * minFrameTime, 1000.0 * maxFrameTime);
+		printf("Render time [ms]: avg %1.2f, max %1.2f\n",
+			1000.0 * sumRenderTime / numFrames, 1000.0 * maxRenderTime);
+		printf("Late frames: %ld\n", numLateFrames);
+	}
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+}
+
+//=========================================================//
+
+void FramePacer::resetStatistics(void)
+{
+	numFrames		= 0;
+	numLateFrames	= 0;
+	sumFrameTime	= 0;
+	minFrameTime	= 1e9;
+	maxFrameTime	= 0;
+	sumRenderTime	= 0;
+	maxRenderTime	= 0;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+void FramePacer::setTargetFrameRate(double targetFrameRate)
+{
+	this->targetFrameRate = targetFrameRate;
+
+	if(targetFrameRate > 0)
+		framePeriod = 1.0 / targetFrameRate;
+	else
+		framePeriod = 0;
+
+	nextFrameTime = clock.getCurrentTimeSeconds();
+}
+
+//=========================================================//
+
+double FramePacer::getTargetFrameRate(void)
+{
+	return targetFrameRate;
+}
+
+//=========================================================//
+
+double FramePacer::getAverageFrameRate(void)
+{
+	if(numFrames == 0 || sumFrameTime <= 0)
+		return 0;
+
+	return numFrames / sumFrameTime;
+}
+
+//=========================================================//
@@ -0,0 +1,66 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Frame Pacer]
+Keeps the graphics loop at a target frame rate instead of redrawing as fast
+as possible, so that rendering does not compete with the haptic thread for
+CPU and memory bandwidth. Also collects frame-time statistics.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class FramePacer
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	cPrecisionClock	clock;
+	double			targetFrameRate;
+	double			framePeriod;
+	double			nextFrameTime;
+	double			frameStartTime;
+	double			lastFrameStartTime;
+
+	// statistics
+	long			numFrames;
+	long			numLateFrames;
+	double			sumFrameTime;
+	double			minFrameTime;
+	double			maxFrameTime;
+	double			sumRenderTime;
+	double			maxRenderTime;
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; a target frame rate of 0 disables the pacing
+	FramePacer(double targetFrameRate);
+	// call at the very start of the display callback
+	void		beginFrame(void);
+	// call after swapping the buffers
+	void		endFrame(void);
+	// milliseconds to wait before the next redisplay
+	int			getMillisecondsToNextFrame(void);
+	// prints the frame-time statistics gathered since the last reset
+	void		printStatistics(void);
+	// clears the frame-time statistics
+	void		resetStatistics(void);
+
+	//========================[METHODS]===setters & getters====//
+	void		setTargetFrameRate(double targetFrameRate);
+	double		getTargetFrameRate(void);
+	double		getAverageFrameRate(void);
+};
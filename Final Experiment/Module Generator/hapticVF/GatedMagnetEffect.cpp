@@ -0,0 +1,99 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Gated Magnet Effect]
+A magnet effect that can be switched on and off by the haptic thread with a
+single flag, so that a guidance line can stay in the scene graph for its whole
+life instead of being added to and removed from the world every time the tool
+enters or leaves its block.
+The force is interpolated from the force profile of the segment the magnet
+belongs to (see ForceProfile) instead of being computed from its material.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+GatedMagnetEffect::GatedMagnetEffect(cGenericObject* parent) : cEffectMagnet(parent)
+{
+	isEnabled		= false;
+	profile			= NULL;
+	radialForce		= NULL;
+	damping			= 0;
+}
+
+//=========================================================//
+
+bool GatedMagnetEffect::computeForce(const cVector3d& a_toolPos,
+									 const cVector3d& a_toolVel,
+									 const unsigned int& a_toolID,
+									 cVector3d& a_reactionForce)
+{
+	if(!isEnabled || profile == NULL)
+	{
+		a_reactionForce.zero();
+		return false;
+	}
+
+	cVector3d toMagnet = cSub(m_parent->m_interactionProjectedPoint, a_toolPos);
+	double distance = toMagnet.length();
+	double forceMagnitude = radialForce->getValue(distance);
+
+	if(distance <= 0 || forceMagnitude <= 0)
+	{
+		a_reactionForce.zero();
+		return false;
+	}
+
+	// both magnets of a segment are scaled by how far along it the tool is
+	forceMagnitude *= profile->progressScale.getValue(cDistance(a_toolPos, segmentStart) * profile->invLength);
+
+	a_reactionForce = cMul(forceMagnitude / distance, toMagnet);
+	if(damping > 0)
+		a_reactionForce.sub(cMul(damping, a_toolVel));
+
+	return true;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+void GatedMagnetEffect::setForceProfile(SegmentForceProfile* profile, ForceLookupTable* radialForce,
+										double damping, cVector3d segmentStart)
+{
+	this->profile		= profile;
+	this->radialForce	= radialForce;
+	this->damping		= damping;
+	this->segmentStart	= segmentStart;
+}
+
+//=========================================================//
+
+void GatedMagnetEffect::setEnabled(bool status)
+{
+	isEnabled = status;
+}
+
+//=========================================================//
+
+bool GatedMagnetEffect::getEnabled(void)
+{
+	return isEnabled;
+}
+
+//=========================================================//
@@ -0,0 +1,58 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Gated Magnet Effect]
+A magnet effect that can be switched on and off by the haptic thread with a
+single flag, so that a guidance line can stay in the scene graph for its whole
+life instead of being added to and removed from the world every time the tool
+enters or leaves its block.
+The force is interpolated from the force profile of the segment the magnet
+belongs to (see ForceProfile) instead of being computed from its material.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class GatedMagnetEffect : public cEffectMagnet
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	bool		isEnabled;		// haptic thread only
+
+	// force profile of the segment
+	SegmentForceProfile*	profile;
+	ForceLookupTable*		radialForce;	// by distance from this magnet
+	double					damping;
+	cVector3d				segmentStart;	// A, in the local frame of the magnet
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the effect starts disabled
+	GatedMagnetEffect(cGenericObject* parent);
+	// interpolates the force profile; returns no force while the effect is disabled
+	virtual bool computeForce(const cVector3d& a_toolPos,
+							  const cVector3d& a_toolVel,
+							  const unsigned int& a_toolID,
+							  cVector3d& a_reactionForce);
+
+	//========================[METHODS]===setters & getters====//
+	// the profile is built and owned by the line
+	void		setForceProfile(SegmentForceProfile* profile, ForceLookupTable* radialForce,
+								double damping, cVector3d segmentStart);
+	void		setEnabled(bool status);
+	bool		getEnabled(void);
+};
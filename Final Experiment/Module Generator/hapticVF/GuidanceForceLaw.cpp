@@ -0,0 +1,176 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Guidance Force Law]
+The force of a guidance magnet as a function of the distance of the tool from
+it. The laws are only evaluated when a path is built, to fill the force
+profiles of its segments (see ForceProfile); the haptic loop interpolates the
+profiles. The law of the session is kept in CommonValues.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+GuidanceForceLaw::~GuidanceForceLaw(void)
+{
+}
+
+//=========================================================//
+
+double GuidanceForceLaw::getDamping(double stiffness)
+{
+	return 0;
+}
+
+//=========================================================//
+
+GuidanceForceLaw* GuidanceForceLaw::create(string name)
+{
+	if(name == "magnet")
+		return new MagnetForceLaw();
+	if(name == "linear")
+		return new LinearForceLaw();
+	if(name == "exponential")
+		return new ExponentialForceLaw(3.0);
+	if(name == "spring-damper")
+		return new SpringDamperForceLaw(0.01);
+
+	string tablePrefix = "table:";
+	if(name.compare(0, tablePrefix.length(), tablePrefix) == 0)
+	{
+		TableForceLaw* law = new TableForceLaw();
+		if(law->loadFromFile(name.substr(tablePrefix.length())))
+			return law;
+		delete law;
+	}
+
+	return NULL;
+}
+
+//=========================================================//
+
+double MagnetForceLaw::computeForce(double distance, double maxForce, double maxDistance, double stiffness)
+{
+	if(distance <= 0 || distance >= maxDistance || stiffness <= 0)
+		return 0;
+
+	// linear up to the maximum force, but never over more than half of the field
+	double limitLinearModel = cMin(maxForce / stiffness, 0.5 * maxDistance);
+	if(distance < limitLinearModel)
+		return stiffness * distance;
+
+	double x = (distance - limitLinearModel) / (maxDistance - limitLinearModel);
+	return stiffness * limitLinearModel * (1.0 - x * x);
+}
+
+//=========================================================//
+
+double LinearForceLaw::computeForce(double distance, double maxForce, double maxDistance, double stiffness)
+{
+	if(distance <= 0 || distance >= maxDistance)
+		return 0;
+
+	return cMin(stiffness * distance, maxForce * (1.0 - distance / maxDistance));
+}
+
+//=========================================================//
+
+ExponentialForceLaw::ExponentialForceLaw(double falloff)
+{
+	this->falloff = falloff;
+}
+
+//=========================================================//
+
+double ExponentialForceLaw::computeForce(double distance, double maxForce, double maxDistance, double stiffness)
+{
+	if(distance <= 0 || distance >= maxDistance)
+		return 0;
+
+	return cMin(stiffness * distance, maxForce * exp(-falloff * distance / maxDistance));
+}
+
+//=========================================================//
+
+SpringDamperForceLaw::SpringDamperForceLaw(double dampingTime)
+{
+	this->dampingTime = dampingTime;
+}
+
+//=========================================================//
+
+double SpringDamperForceLaw::computeForce(double distance, double maxForce, double maxDistance, double stiffness)
+{
+	if(distance <= 0 || distance >= maxDistance)
+		return 0;
+
+	return cMin(stiffness * distance, maxForce);
+}
+
+//=========================================================//
+
+double SpringDamperForceLaw::getDamping(double stiffness)
+{
+	return dampingTime * stiffness;
+}
+
+//=========================================================//
+
+bool TableForceLaw::loadFromFile(string fileName)
+{
+	ifstream myfile (fileName.c_str());
+	if (!myfile.is_open())
+		return false;
+
+	string line;
+	while ( getline (myfile,line) )
+	{
+		size_t pos = line.find(",");
+		if(pos == string::npos)
+			continue;
+
+		distances.push_back(atof(line.substr(0, pos).c_str()));
+		forces.push_back(atof(line.substr(pos + 1).c_str()));
+	}
+	myfile.close();
+
+	return distances.size() >= 2;
+}
+
+//=========================================================//
+
+double TableForceLaw::computeForce(double distance, double maxForce, double maxDistance, double stiffness)
+{
+	if(distance <= 0 || distance >= maxDistance)
+		return 0;
+
+	// the distances of the table are in increasing order
+	double x = distance / maxDistance;
+	if(x <= distances[0])
+		return maxForce * forces[0];
+
+	for(unsigned int i=1; i<distances.size(); i++)
+	{
+		if(x <= distances[i])
+		{
+			double t = (x - distances[i-1]) / (distances[i] - distances[i-1]);
+			return maxForce * (forces[i-1] + t * (forces[i] - forces[i-1]));
+		}
+	}
+
+	return maxForce * forces[forces.size() - 1];
+}
+
+//=========================================================//
@@ -0,0 +1,86 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Guidance Force Law]
+The force of a guidance magnet as a function of the distance of the tool from
+it. The laws are only evaluated when a path is built, to fill the force
+profiles of its segments (see ForceProfile); the haptic loop interpolates the
+profiles. The law of the session is kept in CommonValues.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class GuidanceForceLaw
+{
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// destructor
+	virtual ~GuidanceForceLaw(void);
+	// magnitude of the force at a distance from the magnet; zero from maxDistance on
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness) = 0;
+	// viscous damping applied with the force, for a magnet of the given stiffness
+	virtual double	getDamping(double stiffness);
+
+	// creates a law by name: magnet, linear, exponential, spring-damper or table:<file>;
+	// returns NULL if the name is unknown or the table cannot be read
+	static GuidanceForceLaw*	create(string name);
+};
+
+// a spring near the magnet, fading out quadratically to the edge of the field (as cEffectMagnet)
+class MagnetForceLaw : public GuidanceForceLaw
+{
+public:
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness);
+};
+
+// a spring near the magnet, fading out linearly to the edge of the field
+class LinearForceLaw : public GuidanceForceLaw
+{
+public:
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness);
+};
+
+// a spring near the magnet, decaying exponentially with the distance
+class ExponentialForceLaw : public GuidanceForceLaw
+{
+private:
+	double			falloff;		// decay rate over the whole field
+public:
+	ExponentialForceLaw(double falloff);
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness);
+};
+
+// a saturated spring over the whole field, with viscous damping
+class SpringDamperForceLaw : public GuidanceForceLaw
+{
+private:
+	double			dampingTime;	// damping over stiffness [s]
+public:
+	SpringDamperForceLaw(double dampingTime);
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness);
+	virtual double	getDamping(double stiffness);
+};
+
+// a custom profile read from a file of "distance,force" lines, both normalized to [0,1]
+class TableForceLaw : public GuidanceForceLaw
+{
+private:
+	vector<double>	distances;
+	vector<double>	forces;
+public:
+	// reads the table; returns false if the file cannot be read
+	bool			loadFromFile(string fileName);
+	virtual double	computeForce(double distance, double maxForce, double maxDistance, double stiffness);
+};
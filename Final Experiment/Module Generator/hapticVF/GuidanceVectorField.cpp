@@ -0,0 +1,394 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Guidance Vector Field]
+The guidance force around a whole path, baked once when the path is built:
+a pull towards the closest point of the centerline, following the force law
+of the session, and a push along the direction of travel. Near a bend the
+directions of the segments meeting there are blended, so the push turns with
+the path instead of switching from one segment to the next.
+The force is sampled on a grid split in bricks of 8x8x8 voxels; only the
+bricks the guidance reaches get samples. The haptic loop reads it with one
+trilinear lookup, whatever the length of the path or its number of bends.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+
+static const int	GVF_BRICK_SIZE		= 8;		// voxels per side of a brick
+static const int	GVF_BRICK_SAMPLES	= 9;		// samples per side; the last ones repeat the first of the next brick
+static const int	GVF_BRICK_STRIDE	= 2192;		// floats per brick in the pool: 9x9x9 vectors, padded to whole cache lines
+static const int	GVF_CACHE_LINE		= 64;
+static const int	GVF_VOXELS_PER_RADIUS = 4;
+
+// shared data of the bake of one field
+struct GuidanceBakeJob
+{
+	vector<PathSegment>	segments;		// from the starting point to the end of the path
+	double				totalLength;
+	GuidanceForceLaw*	law;
+	double				pullForce;
+	double				pushForce;
+	double				radius;
+	double				stiffness;
+	cVector3d			origin;
+	double				voxelSize;
+	int					bricksX;
+	int					bricksY;
+	vector<int>			poolBricks;		// the brick of each place of the pool
+	float*				brickPool;
+};
+
+/*=========================================================//
+//==================[HELPER FUNCTIONS]=====================//
+//=========================================================*/
+
+static double getSegmentDistance(const PathSegment& segment, const cVector3d& position, double& along)
+{
+	cVector3d offset = position - segment.start;
+
+	along = cClamp(offset.dot(segment.direction), 0.0, segment.length);
+	return (offset - segment.direction * along).length();
+}
+
+//=========================================================//
+
+static cVector3d computeGuidance(const GuidanceBakeJob& job, const cVector3d& position)
+{
+	// the closest point of the centerline
+	int		closest			= 0;
+	double	closestAlong	= 0;
+	double	distance		= job.radius;
+	vector<double> distances(job.segments.size());
+	for(unsigned int i=0; i<job.segments.size(); i++)
+	{
+		double along;
+		distances[i] = getSegmentDistance(job.segments[i], position, along);
+		if(distances[i] < distance)
+		{
+			distance		= distances[i];
+			closest			= i;
+			closestAlong	= along;
+		}
+	}
+
+	cVector3d force(0, 0, 0);
+	if(distance >= job.radius)
+		return force;
+
+	// pull, towards the centerline
+	if(distance > 0)
+	{
+		const PathSegment& segment = job.segments[closest];
+		cVector3d toCenterline = segment.start + segment.direction * closestAlong - position;
+		force = toCenterline * (job.law->computeForce(distance, job.pullForce, job.radius, job.stiffness) / distance);
+	}
+
+	// push, along the directions of the segments nearly as close as the closest one;
+	// at a bend both segments weigh in and the direction turns smoothly
+	double		blendWidth = 0.5 * job.radius;
+	cVector3d	direction(0, 0, 0);
+	for(unsigned int i=0; i<job.segments.size(); i++)
+	{
+		double weight = 1 - (distances[i] - distance) / blendWidth;
+		if(weight > 0)
+			direction = direction + job.segments[i].direction * weight;
+	}
+	if(direction.length() == 0)
+		return force;
+	direction.normalize();
+
+	// fading out before the end of the path, so the tool is not pushed past it
+	double remaining	= job.totalLength - (job.segments[closest].arcLength + closestAlong);
+	double push			= job.pushForce * (1 - distance / job.radius) * cMin(1.0, remaining / job.radius);
+
+	return force + direction * push;
+}
+
+//=========================================================//
+
+static void computeBrickGuidance(int begin, int end, void* arg)
+{
+	GuidanceBakeJob& job = *(GuidanceBakeJob*)arg;
+
+	for(int place=begin; place<end; place++)
+	{
+		int brick	= job.poolBricks[place];
+		int bx		= brick % job.bricksX;
+		int by		= (brick / job.bricksX) % job.bricksY;
+		int bz		= brick / (job.bricksX * job.bricksY);
+		float* samples = job.brickPool + place * GVF_BRICK_STRIDE;
+
+		for(int z=0; z<GVF_BRICK_SAMPLES; z++)
+		for(int y=0; y<GVF_BRICK_SAMPLES; y++)
+		for(int x=0; x<GVF_BRICK_SAMPLES; x++)
+		{
+			cVector3d position = job.origin + cVector3d(bx * GVF_BRICK_SIZE + x,
+				by * GVF_BRICK_SIZE + y, bz * GVF_BRICK_SIZE + z) * job.voxelSize;
+			cVector3d force = computeGuidance(job, position);
+
+			float* sample = samples + 3 * (x + GVF_BRICK_SAMPLES * (y + GVF_BRICK_SAMPLES * z));
+			sample[0] = (float)force.x;
+			sample[1] = (float)force.y;
+			sample[2] = (float)force.z;
+		}
+	}
+}
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+GuidanceVectorField::GuidanceVectorField(void)
+{
+	bricksX			= 0;
+	bricksY			= 0;
+	bricksZ			= 0;
+	voxelSize		= 0;
+	brickPool		= NULL;
+	numPoolBricks	= 0;
+	origin.zero();
+}
+
+//=========================================================//
+
+GuidanceVectorField::~GuidanceVectorField(void)
+{
+	allocatePool(0);
+}
+
+//=========================================================//
+
+void GuidanceVectorField::allocatePool(int numBricks)
+{
+	if(brickPool != NULL)
+	{
+#if defined(_WIN32)
+		_aligned_free(brickPool);
+#else
+		free(brickPool);
+#endif
+		brickPool = NULL;
+	}
+
+	numPoolBricks = numBricks;
+	if(numBricks == 0)
+		return;
+
+	size_t size = (size_t)numBricks * GVF_BRICK_STRIDE * sizeof(float);
+#if defined(_WIN32)
+	brickPool = (float*)_aligned_malloc(size, GVF_CACHE_LINE);
+#else
+	void* pool = NULL;
+	if(posix_memalign(&pool, GVF_CACHE_LINE, size) == 0)
+		brickPool = (float*)pool;
+#endif
+	if(brickPool == NULL)
+		numPoolBricks = 0;
+}
+
+//=========================================================//
+
+bool GuidanceVectorField::bake(Point* points, int numOfPoints, GuidanceForceLaw* law, double pullForce,
+							   double pushForce, double radius, double stiffness)
+{
+	brickTable.clear();
+	allocatePool(0);
+	bricksX = bricksY = bricksZ = 0;
+
+	if(points == NULL || law == NULL || radius <= 0)
+		return false;
+
+	GuidanceBakeJob job;
+	job.totalLength	= 0;
+	job.law			= law;
+	job.pullForce	= pullForce;
+	job.pushForce	= pushForce;
+	job.radius		= radius;
+	job.stiffness	= stiffness;
+
+	// the segments, as PathProgress measures them, and the box around them
+	cVector3d boundaryMin = points->point;
+	cVector3d boundaryMax = points->point;
+	Point* point = points;
+	for(int i=0; i<numOfPoints-1 && point!=NULL && point->next!=NULL; i++)
+	{
+		PathSegment segment;
+		cVector3d vector	= point->next->point - point->point;
+		segment.start		= point->point;
+		segment.length		= vector.length();
+		segment.arcLength	= job.totalLength;
+		if(segment.length > 0)
+			segment.direction = vector * (1.0 / segment.length);
+		else
+			segment.direction.zero();
+
+		job.segments.push_back(segment);
+		job.totalLength += segment.length;
+		point = point->next;
+
+		boundaryMin.x = cMin(boundaryMin.x, point->point.x);
+		boundaryMin.y = cMin(boundaryMin.y, point->point.y);
+		boundaryMin.z = cMin(boundaryMin.z, point->point.z);
+		boundaryMax.x = cMax(boundaryMax.x, point->point.x);
+		boundaryMax.y = cMax(boundaryMax.y, point->point.y);
+		boundaryMax.z = cMax(boundaryMax.z, point->point.z);
+	}
+	if(job.segments.empty())
+		return false;
+
+	voxelSize		= radius / GVF_VOXELS_PER_RADIUS;
+	origin			= boundaryMin - cVector3d(radius, radius, radius);
+	cVector3d extent = boundaryMax - boundaryMin;
+	double brickSide = GVF_BRICK_SIZE * voxelSize;
+	bricksX			= (int)ceil((extent.x + 2 * radius) / brickSide);
+	bricksY			= (int)ceil((extent.y + 2 * radius) / brickSide);
+	bricksZ			= (int)ceil((extent.z + 2 * radius) / brickSide);
+	int numBricks	= bricksX * bricksY * bricksZ;
+
+	// the bricks within reach of a segment, measured from their centers
+	double halfDiagonal = 0.5 * brickSide * sqrt(3.0);
+	brickTable.assign(numBricks, -1);
+	for(int brick=0; brick<numBricks; brick++)
+	{
+		int bx = brick % bricksX;
+		int by = (brick / bricksX) % bricksY;
+		int bz = brick / (bricksX * bricksY);
+		cVector3d center = origin + cVector3d(bx + 0.5, by + 0.5, bz + 0.5) * brickSide;
+
+		for(unsigned int i=0; i<job.segments.size(); i++)
+		{
+			double along;
+			if(getSegmentDistance(job.segments[i], center, along) <= radius + halfDiagonal)
+			{
+				brickTable[brick] = job.poolBricks.size();
+				job.poolBricks.push_back(brick);
+				break;
+			}
+		}
+	}
+
+	allocatePool(job.poolBricks.size());
+	if(numPoolBricks != (int)job.poolBricks.size())
+	{
+		brickTable.clear();
+		return false;
+	}
+
+	job.origin		= origin;
+	job.voxelSize	= voxelSize;
+	job.bricksX		= bricksX;
+	job.bricksY		= bricksY;
+	job.brickPool	= brickPool;
+	WorkerPool::getInstance()->parallelFor(numPoolBricks, computeBrickGuidance, &job);
+
+	return true;
+}
+
+//=========================================================//
+
+cVector3d GuidanceVectorField::getForce(const cVector3d& position)
+{
+	cVector3d force(0, 0, 0);
+	if(brickTable.empty())
+		return force;
+
+	double gx = (position.x - origin.x) / voxelSize;
+	double gy = (position.y - origin.y) / voxelSize;
+	double gz = (position.z - origin.z) / voxelSize;
+	if(gx < 0 || gy < 0 || gz < 0 ||
+		gx > bricksX * GVF_BRICK_SIZE || gy > bricksY * GVF_BRICK_SIZE || gz > bricksZ * GVF_BRICK_SIZE)
+		return force;
+
+	int x = cMin((int)gx, bricksX * GVF_BRICK_SIZE - 1);
+	int y = cMin((int)gy, bricksY * GVF_BRICK_SIZE - 1);
+	int z = cMin((int)gz, bricksZ * GVF_BRICK_SIZE - 1);
+	double fx = gx - x;
+	double fy = gy - y;
+	double fz = gz - z;
+
+	// first indirection: the brick
+	int entry = brickTable[x / GVF_BRICK_SIZE + bricksX * (y / GVF_BRICK_SIZE + bricksY * (z / GVF_BRICK_SIZE))];
+	if(entry < 0)
+		return force;
+
+	// second indirection: the eight samples around the position, all in the brick
+	const float* corner	= brickPool + entry * GVF_BRICK_STRIDE + 3 * ((x % GVF_BRICK_SIZE) +
+		GVF_BRICK_SAMPLES * ((y % GVF_BRICK_SIZE) + GVF_BRICK_SAMPLES * (z % GVF_BRICK_SIZE)));
+	const int stepX		= 3;
+	const int stepY		= 3 * GVF_BRICK_SAMPLES;
+	const int stepZ		= 3 * GVF_BRICK_SAMPLES * GVF_BRICK_SAMPLES;
+
+	double weights[8] =
+	{
+		(1 - fx) * (1 - fy) * (1 - fz),	fx * (1 - fy) * (1 - fz),
+		(1 - fx) * fy * (1 - fz),		fx * fy * (1 - fz),
+		(1 - fx) * (1 - fy) * fz,		fx * (1 - fy) * fz,
+		(1 - fx) * fy * fz,				fx * fy * fz
+	};
+	for(int i=0; i<8; i++)
+	{
+		const float* sample = corner + ((i & 1) ? stepX : 0) + ((i & 2) ? stepY : 0) + ((i & 4) ? stepZ : 0);
+		force.x += weights[i] * sample[0];
+		force.y += weights[i] * sample[1];
+		force.z += weights[i] * sample[2];
+	}
+
+	return force;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+void GuidanceVectorField::release(void)
+{
+	vector<int>().swap(brickTable);
+	allocatePool(0);
+	bricksX = bricksY = bricksZ = 0;
+}
+
+//=========================================================//
+
+bool GuidanceVectorField::isEmpty(void)
+{
+	return brickTable.empty();
+}
+
+//=========================================================//
+
+int GuidanceVectorField::getNumBricks(void)
+{
+	return (int)brickTable.size();
+}
+
+//=========================================================//
+
+int GuidanceVectorField::getNumPoolBricks(void)
+{
+	return numPoolBricks;
+}
+
+//=========================================================//
+
+long GuidanceVectorField::getMemorySize(void)
+{
+	return (long)(brickTable.size() * sizeof(int)) + (long)numPoolBricks * GVF_BRICK_STRIDE * sizeof(float);
+}
+
+//=========================================================//
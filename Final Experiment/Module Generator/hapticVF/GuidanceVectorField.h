@@ -0,0 +1,75 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Guidance Vector Field]
+The guidance force around a whole path, baked once when the path is built:
+a pull towards the closest point of the centerline, following the force law
+of the session, and a push along the direction of travel. Near a bend the
+directions of the segments meeting there are blended, so the push turns with
+the path instead of switching from one segment to the next.
+The force is sampled on a grid split in bricks of 8x8x8 voxels; only the
+bricks the guidance reaches get samples. The haptic loop reads it with one
+trilinear lookup, whatever the length of the path or its number of bends.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class GuidanceVectorField
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	int				bricksX;			// bricks along each axis
+	int				bricksY;
+	int				bricksZ;
+	cVector3d		origin;				// position of sample (0,0,0)
+	double			voxelSize;
+	vector<int>		brickTable;			// per brick, its place in the pool, or -1 if the guidance does not reach it
+	float*			brickPool;			// x, y, z of the force of each sample of the bricks near the path
+	int				numPoolBricks;
+
+	//========================[METHODS]========================//
+	// not copyable, the pool is owned
+	GuidanceVectorField(const GuidanceVectorField&);
+	GuidanceVectorField& operator=(const GuidanceVectorField&);
+
+	// replaces the pool by an uninitialized one of the given number of bricks
+	void		allocatePool(int numBricks);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; an empty field gives no force
+	GuidanceVectorField(void);
+	// destructor
+	~GuidanceVectorField(void);
+	// samples the guidance along the polyline of the first numOfPoints waypoints of the list:
+	// the pull follows the law up to pullForce and stops at radius, the push fades from
+	// pushForce on the centerline to nothing at radius
+	bool		bake(Point* points, int numOfPoints, GuidanceForceLaw* law, double pullForce,
+					 double pushForce, double radius, double stiffness);
+	// trilinear force at a position; zero where the guidance does not reach
+	cVector3d	getForce(const cVector3d& position);
+	// frees the table and the pool; the field is empty afterwards
+	void		release(void);
+
+	//========================[METHODS]===setters & getters====//
+	bool		isEmpty(void);
+	int			getNumBricks(void);
+	int			getNumPoolBricks(void);
+	// bytes used by the brick table and the pool
+	long		getMemorySize(void);
+};
@@ -0,0 +1,89 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Haptic Snapshot]
+The state of the tool and the fixtures as seen at the end of one haptic tick.
+The haptic thread publishes one snapshot per tick through a lock-free triple
+buffer and the graphics thread takes the latest complete one once per frame,
+so a frame never mixes the state of two different ticks.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+HapticSnapshot::HapticSnapshot()
+{
+	tick				= 0;
+	proxyGlobalPos		= cVector3d(0,0,0);
+	proxyGlobalRot.identity();
+	deviceGlobalPos		= cVector3d(0,0,0);
+	force				= cVector3d(0,0,0);
+	areFixturesAttached	= false;
+	isInsideThePath		= false;
+	numOfCollisions		= 0;
+	trials				= 0;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+	numCollisionQueries	= 0;
+	numCollisionCacheHits	= 0;
+	numVisitedNodes		= 0;
+	numTestedTriangles	= 0;
+	tickCollisionQueries	= 0;
+	tickVisitedNodes	= 0;
+	tickTestedTriangles	= 0;
+
+	isToolAligning		= false;
+	toolAlignment.identity();
+	pathSegment			= 0;
+	pathProgress		= 0;
+	pathDeviation		= 0;
+}
+
+//=========================================================//
+
+SnapshotBuffer::SnapshotBuffer()
+{
+	writeSlot	= 0;
+	latestSlot	= 1;
+	readSlot	= 2;
+}
+
+//=========================================================//
+
+HapticSnapshot* SnapshotBuffer::beginWrite(void)
+{
+	return &slots[writeSlot];
+}
+
+//=========================================================//
+
+void SnapshotBuffer::endWrite(void)
+{
+	// hand the filled slot over and take back whichever slot was published before
+	writeSlot = atomicExchange(&latestSlot, writeSlot | FRESH_FLAG) & ~FRESH_FLAG;
+}
+
+//=========================================================//
+
+HapticSnapshot SnapshotBuffer::read(void)
+{
+	// only swap when something new was published, otherwise keep showing the last one
+	if(atomicLoad(&latestSlot) & FRESH_FLAG)
+		readSlot = atomicExchange(&latestSlot, readSlot) & ~FRESH_FLAG;
+
+	return slots[readSlot];
+}
+
+//=========================================================//
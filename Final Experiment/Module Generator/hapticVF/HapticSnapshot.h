@@ -0,0 +1,95 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Haptic Snapshot]
+The state of the tool and the fixtures as seen at the end of one haptic tick.
+The haptic thread publishes one snapshot per tick through a lock-free triple
+buffer and the graphics thread takes the latest complete one once per frame,
+so a frame never mixes the state of two different ticks.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+typedef struct HapticSnapshot{
+
+public:
+	//========================[VARIABLES]======================//
+	unsigned long	tick;
+
+	// tool
+	cVector3d		proxyGlobalPos;
+	cMatrix3d		proxyGlobalRot;
+	cVector3d		deviceGlobalPos;
+	cVector3d		force;
+
+	// fixtures
+	bool			areFixturesAttached;
+	bool			isInsideThePath;
+	int				numOfCollisions;
+	int				trials;
+
+	// the nodes of the collision scene of the proxy (see CommonValues::collisionWorld), counted
+	// when it changes
+	int				numCollisionNodes;
+	int				numCollisionMeshes;
+	long			numCollisionQueries;	// of the mesh trees so far (see MeshCollisionBVH)
+	long			numCollisionCacheHits;	// of which answered from the triangles of the last query
+	long			numVisitedNodes;		// of the trees, so far
+	long			numTestedTriangles;
+
+	// what the proxy cost in the last tick
+	int				tickCollisionQueries;
+	int				tickVisitedNodes;
+	int				tickTestedTriangles;
+
+
+	// the orientation the drawn tool turns to, while the guidance of a line is on
+	bool			isToolAligning;
+	cMatrix3d		toolAlignment;
+
+	// progress along the path (see PathProgress)
+	int				pathSegment;
+	double			pathProgress;
+	double			pathDeviation;
+
+	//========================[METHODS]========================//
+	HapticSnapshot();
+
+};
+
+class SnapshotBuffer
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	HapticSnapshot	slots[3];
+	int				writeSlot;		// haptic thread only
+	int				readSlot;		// graphics thread only
+	volatile long	latestSlot;		// last published slot, plus FRESH_FLAG until it is read
+
+	static const long FRESH_FLAG = 4;
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	SnapshotBuffer();
+	// returns the slot the haptic thread fills for this tick
+	HapticSnapshot*	beginWrite(void);
+	// publishes the slot filled since beginWrite()
+	void			endWrite(void);
+	// returns the latest published snapshot (graphics thread)
+	HapticSnapshot	read(void);
+};
@@ -32,12 +32,19 @@ MagneticLine::MagneticLine(cVector3d A, cVector3d B)
 	lineShape = new cShapeLine(A, B);
 	lineShape->m_ColorPointA.set(1, 0, 0);
 	lineShape->m_ColorPointB.set(1, 0, 0);
+	sphereShape = NULL;
+	lineEffect = NULL;
+	sphereEffect = NULL;
 
 	this->isSecondLine = false;
 	this->isLastLine = false;
 
-	this->isToolOriented = false;
-	this->orientationCount = 0;
+	this->isMagneticPathShown = false;
+	this->areShapesInScene = false;
+	this->areEffectsAdded = false;
+	this->segmentIndex = 0;
+	this->peakForce = 0;
+	calculateToolAlignment();
 
 	if(!values->V)
 		setLineAsTransparent(true);
@@ -55,12 +62,35 @@ MagneticLine::MagneticLine(void)
 	lineShape = new cShapeLine(A, B);
 	lineShape->m_ColorPointA.set(1, 0, 0);
 	lineShape->m_ColorPointB.set(1, 0, 0);
+	sphereShape = NULL;
+	lineEffect = NULL;
+	sphereEffect = NULL;
 
 	this->isSecondLine = false;
 	this->isLastLine = false;
 
-	this->isToolOriented = false;
-	this->orientationCount = 0;
+	this->isMagneticPathShown = false;
+	this->areShapesInScene = false;
+	this->areEffectsAdded = false;
+	this->segmentIndex = 0;
+	this->peakForce = 0;
+	calculateToolAlignment();
+}
+
+//=========================================================//
+
+MagneticLine::~MagneticLine(void)
+{
+	// a line that never got a block (the placeholder of the first bend) still owns its shape
+	if(!areShapesInScene)
+		delete lineShape;
+
+	// the magnets are only added when the guidance comes from the lines
+	if(!areEffectsAdded)
+	{
+		delete lineEffect;
+		delete sphereEffect;
+	}
 }
 
 //=========================================================//
@@ -97,212 +127,196 @@ void MagneticLine::setupInitialForceField(void)
 	double lineDistance		= values->stdBlockRadius;
 	double sphereDistance	= values->stdBlockHeight * heightScaleFactor;
 
+	buildForceProfile(lineForce, lineDistance, sphereForce, sphereDistance);
+
 	// horizontal magnetic force (depends on radius)
-	lineShape->m_material.setMagnetMaxForce(lineForce);
 	lineShape->m_material.setStiffness(0.4 * values->stiffnessMax);
-	lineShape->m_material.setMagnetMaxDistance(lineDistance);
-	magneticEffect = new cEffectMagnet(lineShape);
-    if(values->G)lineShape->addEffect(magneticEffect);
+	lineEffect = new GatedMagnetEffect(lineShape);
+	lineEffect->setForceProfile(&forceProfile, &forceProfile.lineForce, forceProfile.lineDamping, A);
+	areEffectsAdded = values->G && !values->isGuidanceFieldEnabled;
+    if(areEffectsAdded)lineShape->addEffect(lineEffect);
 
-	// vertical magnetic force (depends on height)
+	// vertical magnetic force (depends on height); the sphere's frame is centered on B
 	sphereShape = new cShapeSphere(0.0001 * values->BLOCK_SCALE_FACTOR);	
 	sphereShape->setPos(B);
-	sphereShape->m_material.setMagnetMaxForce(sphereForce);
 	sphereShape->m_material.setStiffness(0.4 * values->stiffnessMax);
-	sphereShape->m_material.setMagnetMaxDistance(sphereDistance);
-	magneticEffect = new cEffectMagnet(sphereShape);
-	if(values->G)sphereShape->addEffect(magneticEffect);
+	sphereEffect = new GatedMagnetEffect(sphereShape);
+	sphereEffect->setForceProfile(&forceProfile, &forceProfile.sphereForce, forceProfile.sphereDamping, A - B);
+	if(areEffectsAdded)sphereShape->addEffect(sphereEffect);
+
+
+	// the shapes stay in the path for good; the force field is switched by the effects
+	// and the display by the graphics thread (see setForceFieldStatus)
+	lineShape->setShowEnabled(false, true);
+	sphereShape->setShowEnabled(false, true);
+	values->fixtureRoot->addChild(lineShape);
+	values->fixtureRoot->addChild(sphereShape);
+	areShapesInScene = true;
 	
 	setGuidance(true);
 	isForceFieldEnabled = false;
 	block->getBottomMesh()->setAsGhost(true);
 	block->getTopMesh()->setAsGhost(false);
-	setForceFieldStatus(false);
 }
 
 //=========================================================//
 
+void MagneticLine::buildForceProfile(double lineForce, double lineDistance, double sphereForce, double sphereDistance)
+{
+	const int	NUM_FORCE_SAMPLES		= 128;
+	const int	NUM_PROGRESS_SAMPLES	= 101;		// one sample per percent of the segment
+	double		stiffness				= 0.4 * values->stiffnessMax;
+
+	forceProfile.lineForce.build(values->guidanceForceLaw, lineForce, lineDistance, stiffness, NUM_FORCE_SAMPLES);
+	forceProfile.sphereForce.build(values->guidanceForceLaw, sphereForce, sphereDistance, stiffness, NUM_FORCE_SAMPLES);
+	forceProfile.lineDamping	= values->guidanceForceLaw->getDamping(stiffness);
+	forceProfile.sphereDamping	= values->guidanceForceLaw->getDamping(stiffness);
+
+	// the guidance builds up over the first 20% of the segment, then goes up to 120%
+	// (corners keep the reduced force, so the tool is not pulled off the bend)
+	forceProfile.invLength = 1.0 / (A - B).length();
+	forceProfile.progressScale.resize(NUM_PROGRESS_SAMPLES, 1.0);
+	for(int i=0; i<NUM_PROGRESS_SAMPLES; i++)
+	{
+		double percentage = (double)i / (NUM_PROGRESS_SAMPLES - 1);
+
+		if(percentage < 0.2)
+			forceProfile.progressScale.set(i, percentage);
+		else if(block->isCorner)
+			forceProfile.progressScale.set(i, 0.2);
+		else
+			forceProfile.progressScale.set(i, 1.2);
+	}
+}
+
+//=========================================================//
+
+template<class Policy>
+bool MagneticLine::onTopContact(void)
+{
+	if(!isGuidanceOn || isForceFieldEnabled)
+		return false;
+
+	if(Policy::visual)
+		block->setHighlightBlockAsActive(true);
+	isForceFieldEnabled = true;
+	block->getTopMesh()->setAsGhost(true);
+	block->getBottomMesh()->setAsGhost(false);
+	setForceFieldStatus<Policy>(true);
+	// the trial itself is kept by the session service
+	if(this->isSecondLine)
+	{
+		values->isInsideThePath = true;
+		values->sessionEvents->push(SESSION_PATH_ENTERED, values->hapticTime);
+	}
+	peakForce = 0;
+	values->sessionEvents->push(SESSION_SEGMENT_ENTERED, values->hapticTime, segmentIndex, 0);
+	return true;
+}
+
+//=========================================================//
+
+template<class Policy>
+bool MagneticLine::onBottomContact(void)
+{
+	if(!isGuidanceOn || !isForceFieldEnabled)
+		return false;
+
+	if(Policy::visual)
+		block->setHighlightBlockAsActive(false);
+
+	isForceFieldEnabled = false;
+	block->getBottomMesh()->setAsGhost(true);
+	block->getTopMesh()->setAsGhost(false);
+	setForceFieldStatus<Policy>(false);
+	values->sessionEvents->push(SESSION_SEGMENT_EXITED, values->hapticTime, segmentIndex, peakForce);
+	if(this->isLastLine)
+	{
+		values->isInsideThePath = false;
+		values->sessionEvents->push(SESSION_PATH_EXITED, values->hapticTime);
+	}
+	return true;
+}
+
+// one instance per feedback configuration
+template bool MagneticLine::onTopContact<NoFeedbackPolicy>(void);
+template bool MagneticLine::onTopContact<GuidancePolicy>(void);
+template bool MagneticLine::onTopContact<VPolicy>(void);
+template bool MagneticLine::onTopContact<GVPolicy>(void);
+template bool MagneticLine::onBottomContact<NoFeedbackPolicy>(void);
+template bool MagneticLine::onBottomContact<GuidancePolicy>(void);
+template bool MagneticLine::onBottomContact<VPolicy>(void);
+template bool MagneticLine::onBottomContact<GVPolicy>(void);
+
+//=========================================================//
+
 void MagneticLine::updateHaptics(void)
 {
-	if(isGuidanceOn)
+	// the guidance force along the segment comes from its force profile (see GatedMagnetEffect);
+	// the drawn tool is aligned with the segment by the graphics thread
+	if(!isForceFieldEnabled)
+		return;
+
+	double force = values->tool->m_lastComputedGlobalForce.length();
+	if(force > peakForce)
+		peakForce = force;
+}
+
+//=========================================================//
+
+void MagneticLine::calculateToolAlignment(void)
+{
+	toolAlignment = getRotationBetween(cVector3d(1,0,0), vector);
+}
+
+//=========================================================//
+
+cMatrix3d MagneticLine::getRotationBetween(cVector3d from, cVector3d to)
+{
+	cMatrix3d	rotMatrix;
+	cQuaternion	quat;
+
+	rotMatrix.identity();
+	if(from.length() == 0 || to.length() == 0)
+		return rotMatrix;
+
+	from.normalize();
+	to.normalize();
+
+	double cosAngle = from.dot(to);
+	if(cosAngle > 1)	cosAngle = 1;
+	if(cosAngle < -1)	cosAngle = -1;
+
+	cVector3d axis = from.crossAndReturn(to);
+	if(axis.length() < 1e-9)
 	{
-		if(values->tool->isInContact(block->getTopMesh()->getChild(0)))
-		{
-			if(!isForceFieldEnabled)
-			{
-				block->setHighlightBlockAsActive(true);
-				isForceFieldEnabled = true;
-				block->getTopMesh()->setAsGhost(true);
-				block->getBottomMesh()->setAsGhost(false);
-				setForceFieldStatus(true);
-				if(this->isSecondLine)
-				{
-					stringstream ss;
-					ss << values->trials;
-					string trialNum = ss.str();
-					string extension = ".txt";
-					string fileName = "../Debug/OUTPUT_FORCES_" + values->moduleName + string("_trial") + trialNum + extension;
-					values->outfileForces.open((fileName));
-					values->isInsideThePath = true;
-					time(&values->startingTime);
-					values->startingNumCollisions = values->numOfCollisions;
-				}
-			}
-		}
-
-		if(isForceFieldEnabled)
-		{
-			if(!this->isToolOriented)
-			{
-				orientationCount++;	
-				cQuaternion quat;
-				cMatrix3d	rotMatrix;
-				double directionAngle;
-
-				cVector3d v1 = values->tool->getProxyGlobalPos() - values->toolTipEndSphere->getGlobalPos();
-				v1.normalize();
-				cVector3d v2 = this->getVector();
-				v2.normalize();
-
-				cVector3d axis = v1.crossAndReturn(v2);
-				double angle = acos(v1.dot(v2));
-				quat.fromAxisAngle(axis, angle);
-				rotMatrix.identity();
-				quat.toRotMat(rotMatrix);
-
-				if(axis.equals(cVector3d(0,0,0))) // the case where the vector is parallel to the tool
-				{
-					directionAngle = acos((v1.dot(v2))/((v1.length())*(v2.length())));
-					directionAngle = cRadToDeg(directionAngle);
-
-					if(directionAngle !=0 )
-					{
-						values->tool->m_proxyMesh->rotate(cVector3d(1,0,0), 180);
-						values->toolTipEndSphere->rotate(cVector3d(1,0,0), 180);
-					}
-
-				}else
-				{
-					values->tool->m_proxyMesh->rotate(rotMatrix);
-					values->toolTipEndSphere->rotate(rotMatrix);
-				}
-
-			}
-
-				if(orientationCount>50)
-				this->isToolOriented = true;
-		}
-
-		if(values->tool->isInContact(block->getBottomMesh()->getChild(0)))
-		{
-			if(isForceFieldEnabled)
-			{
-				block->setHighlightBlockAsActive(false);
-
-				isForceFieldEnabled = false;
-				block->getBottomMesh()->setAsGhost(true);
-				block->getTopMesh()->setAsGhost(false);
-				setForceFieldStatus(false);
-				if(this->isLastLine)
-				{
-					values->isInsideThePath = false;
-					time(&values->endingTime);
-					if(values->trials==1)values->totalTime1 = difftime(values->endingTime, values->startingTime);
-					if(values->trials==2)values->totalTime2 = difftime(values->endingTime, values->startingTime);
-					if(values->trials==3)values->totalTime3 = difftime(values->endingTime, values->startingTime);
-					values->endingNumCollisions = values->numOfCollisions;
-					if(values->trials==1)values->totalNumCollisions1 = values->endingNumCollisions - values->startingNumCollisions;
-					if(values->trials==2)values->totalNumCollisions2 = values->endingNumCollisions - values->startingNumCollisions;
-					if(values->trials==3)values->totalNumCollisions3 = values->endingNumCollisions - values->startingNumCollisions;
-					if(values->numOfMidPoints>2)
-					{
-						if(!values->isTutorialModule)values->trials++;
-						if(values->trials>=4)
-						{
-							cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-							cout<<"Thank you for your patience."<<endl;
-							cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-							cout<<"Please rate the effectivenes of guidance of this module."<<endl;
-							cout<<"Effectivenss of guidance: the easieness of navigating from"<<endl;
-							cout<<"the beginning till the end with the highest accuracy in the"<<endl;
-							cout<<"shortest time period."<<endl;
-							cout<<"Please enter the number corresponding to your rating:"<<endl;
-							cout<<"[5] - Excellent"<<endl;
-							cout<<"[4] - Very Good"<<endl;
-							cout<<"[3] - Good"<<endl;
-							cout<<"[2] - Not Bad"<<endl;
-							cout<<"[1] - Poor"<<endl;
-							cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-
-							int rating;
-							cin>>rating;
-							cout<<endl;
-							cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-
-							values->averageTime = (values->totalTime1 + values->totalTime2 + values->totalTime3)/3;
-							values->averageTotalNumCollisions = (values->totalNumCollisions1 +
-								values->totalNumCollisions2 + values->totalNumCollisions3)/3;
-
-							string fileName;
-							stringstream ss;
-							ss << values->trials - 1;
-							string trialNum = ss.str();
-							string extension = ".txt";
-
-							fileName = "../Debug/OUTPUT_VALUES_" + values->moduleName + extension;
-							
-							values->outfileCollisionTime.open((fileName));
-							values->outfileCollisionTime<<"Total Time1: "<<values->totalTime1<<" , ";
-							values->outfileCollisionTime<<"Collisions1: "<<values->totalNumCollisions1<<endl;
-							values->outfileCollisionTime<<"Total Time2: "<<values->totalTime2<<" , ";
-							values->outfileCollisionTime<<"Collisions2: "<<values->totalNumCollisions2<<endl;
-							values->outfileCollisionTime<<"Total Time3: "<<values->totalTime3<<" , ";
-							values->outfileCollisionTime<<"Collisions3: "<<values->totalNumCollisions3<<endl;
-							values->outfileCollisionTime<<"Average Total Time: "<<values->averageTime<<" , ";
-							values->outfileCollisionTime<<"Average Total Num of Collisions: "<<values->averageTotalNumCollisions<<endl;
-							values->outfileCollisionTime<<"Rating: "<<rating<<endl;
-							values->outfileCollisionTime.close();
-
-							cout<<"Module [" << values->moduleName << "] has ended.\n";
-							cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-							exit(0);
-							values->hasModuleEnded = true;
-						}else
-							if(!values->isTutorialModule)printf("Trial # %d\nPlease change the orientation to perform the next trial.\nTo change the orientation, press the haptic switch and move the camera around.\n", values->trials);
-					}
-					values->outfileForces.close();
-					
-				}
-			}
-		}
-
-		if(isForceFieldEnabled)
-		{
-			double distance = values->tool->getDeviceGlobalPos().distance(lineShape->m_pointA);
-			double length = (A-B).length();
-			double percentage = (distance / length) ;
-
-			if(percentage  < 0.2)
-			{
-				isThresholdPassed = false;
-				scaleForce(percentage);
-			}
-			else if(!isThresholdPassed)
-			{
-				if(!block->isCorner)
-				scaleForce(1.2);
-				isThresholdPassed = true;
-			}
-
-		}else
-		{
-			this->isToolOriented = false;
-			this->orientationCount = 0;
-		}
+		// parallel: nothing to do; opposite: half a turn about any perpendicular axis
+		if(cosAngle > 0)
+			return rotMatrix;
+
+		axis = from.crossAndReturn(cVector3d(1,0,0));
+		if(axis.length() < 1e-9)
+			axis = from.crossAndReturn(cVector3d(0,1,0));
 	}
-	
+	axis.normalize();
+
+	quat.fromAxisAngle(axis, acos(cosAngle));
+	quat.toRotMat(rotMatrix);
+	return rotMatrix;
+}
+
+//=========================================================//
 
-	values->tool->applyForces();
+void MagneticLine::subscribeContacts(ContactSubscriptionMap& subscriptions)
+{
+	ContactSubscription subscription;
+	subscription.block	= block;
+	subscription.line	= this;
+
+	subscription.role = CONTACT_SEGMENT_TOP;
+	subscriptions[block->getTopMesh()->getChild(0)] = subscription;
+	subscription.role = CONTACT_SEGMENT_BOTTOM;
+	subscriptions[block->getBottomMesh()->getChild(0)] = subscription;
 }
 
 //=========================================================//
@@ -316,6 +330,7 @@ void MagneticLine::setA(cVector3d A)
 {
 	this->A = A;
 	vector = B - A;
+	calculateToolAlignment();
 }
 
 //=========================================================//
@@ -324,6 +339,7 @@ void MagneticLine::setB(cVector3d B)
 {
 	this->B = B;
 	vector = B - A;
+	calculateToolAlignment();
 }
 
 //=========================================================//
@@ -333,6 +349,7 @@ void MagneticLine::setVector(cVector3d A, cVector3d B)
 	this->A = A;
 	this->B = B;
 	vector = B - A;
+	calculateToolAlignment();
 	lineShape = new cShapeLine(A, B);
 	lineShape->m_ColorPointA.set(1, 0, 0);
 	lineShape->m_ColorPointB.set(1, 0, 0);
@@ -393,24 +410,43 @@ bool MagneticLine::getGuidance()
 
 //=========================================================//
 
+cMatrix3d MagneticLine::getToolAlignment()
+{
+	return this->toolAlignment;
+}
+
+//=========================================================//
+
+void MagneticLine::setSegmentIndex(int segmentIndex)
+{
+	this->segmentIndex = segmentIndex;
+}
+
+//=========================================================//
+
+int MagneticLine::getSegmentIndex()
+{
+	return this->segmentIndex;
+}
+
+//=========================================================//
+
+template<class Policy>
 void MagneticLine::setForceFieldStatus(bool status)
 {
-	if(status)	//if true
+	// the forces change in this tick, in the modules with magnets; the display follows
+	// at the next frame
+	if(Policy::guidance)
 	{
-		if(!isMagneticPathAdded)
-		{
-			values->world->addChild(lineShape);
-			values->world->addChild(sphereShape);
-			isMagneticPathAdded = true;
-		}
-	} else		//if false
+		lineEffect->setEnabled(status);
+		sphereEffect->setEnabled(status);
+	}
+
+	if(status != isMagneticPathShown)
 	{
-		if(isMagneticPathAdded)
-		{
-			values->world->removeChild(lineShape);
-			values->world->removeChild(sphereShape);
-			isMagneticPathAdded = false;
-		}
+		values->sceneCommands->setShowEnabled(lineShape, status);
+		values->sceneCommands->setShowEnabled(sphereShape, status);
+		isMagneticPathShown = status;
 	}
 }
 
@@ -432,36 +468,6 @@ void MagneticLine::setGraphicalDisplayHidden(bool status)
 
 //=========================================================//
 
-void MagneticLine::scaleForce()
-{
-	double lineForce		= 0.3 * values->forceMax * values->forceScaleFactor;
-	double sphereForce		= 0.4 * values->forceMax * values->forceScaleFactor;
-
-	// horizontal magnetic force (depends on radius)
-	lineShape->m_material.setMagnetMaxForce(lineForce);
-	lineShape->m_material.setStiffness(0.4 * values->stiffnessMax);
-
-	// vertical magnetic force (depends on height)
-	sphereShape->m_material.setMagnetMaxForce(sphereForce);
-}
-
-//=========================================================//
-
-void MagneticLine::scaleForce(double scaleFactor)
-{
-	double lineForce		= 0.3 * values->forceMax * values->forceScaleFactor * scaleFactor;
-	double sphereForce		= 0.4 * values->forceMax * values->forceScaleFactor * scaleFactor;
-
-	// horizontal magnetic force (depends on radius)
-	lineShape->m_material.setMagnetMaxForce(lineForce);
-	lineShape->m_material.setStiffness(0.4 * values->stiffnessMax);
-
-	// vertical magnetic force (depends on height)
-	sphereShape->m_material.setMagnetMaxForce(sphereForce);
-}
-
-//=========================================================//
-
 void MagneticLine::setLineAsTransparent(bool status)
 {
 	lineShape->setUseTransparency(true, true);
@@ -33,22 +33,30 @@ protected:
 	cShapeSphere*	sphereShape;
 	cMesh*			magneticPath;
 	VFBlock*		block;
-	cEffectMagnet*	magneticEffect;
+	GatedMagnetEffect*	lineEffect;
+	GatedMagnetEffect*	sphereEffect;
+	SegmentForceProfile	forceProfile;
 	double			heightScaleFactor;
 	bool			isGuidanceOn;
 	bool			isForceFieldEnabled;
-	bool			isMagneticPathAdded;
+	bool			isMagneticPathShown;
 	bool			isInsideBlock;
+	bool			areShapesInScene;	// the shapes, once under the fixture root, are deleted with it
+	bool			areEffectsAdded;	// ... and so are the effects added to them
 
-	bool			isToolOriented;
-	int				orientationCount;
-	bool			isThresholdPassed;
+	cMatrix3d		toolAlignment;		// turns the x axis onto the direction of the line
+
+	int				segmentIndex;		// position of the line in its path
+	double			peakForce;			// largest tool force since the guidance turned on
 
 	//========================[METHODS]========================//
 	// calculates the height scale factor w.r.t. the standard height
 	// this helps to obtain the corresponding magnetic force proportional to the line's height
 	void		calculateHeightScaleFactor(void);
-	void		scaleForce(double scaleFactor);
+	// fills the force profile of the segment with the force law in CommonValues
+	void		buildForceProfile(double lineForce, double lineDistance, double sphereForce, double sphereDistance);
+	// precomputes the orientation the tool is turned to while the guidance is on
+	void		calculateToolAlignment(void);
 
 public:
 	//========================[VARIABLES]======================//	
@@ -60,20 +68,32 @@ public:
 	// constructors
 	MagneticLine();
 	MagneticLine(cVector3d A, cVector3d B);
+	// destructor; deletes what the scene graph does not hold
+	~MagneticLine(void);
 	// sets up the initial force field of the line
 	void		setupInitialForceField(void);
 	// pass the block containing the line
 	void		setBlock(VFBlock* block);
-	// include this in the main haptic loop
+	// called by the fixture pipeline of the module (see FixturePipeline)
+	// the proxy touched the top cap; returns true if the guidance turned on
+	template<class Policy>
+	bool		onTopContact(void);
+	// the proxy touched the bottom cap; returns true if the guidance turned off
+	template<class Policy>
+	bool		onBottomContact(void);
+	// every tick while the guidance of the line is on
 	void		updateHaptics(void);
+	// the smallest rotation that turns the direction from onto the direction to
+	static cMatrix3d	getRotationBetween(cVector3d from, cVector3d to);
+	// registers the caps of the block for the contact events (see ContactEventStream)
+	void		subscribeContacts(ContactSubscriptionMap& subscriptions);
 	// prints the details of the lines (its coordinates and length)
 	void		print();
 	// sets the forcefield of the line on or off
+	template<class Policy>
 	void		setForceFieldStatus(bool status);
 	// hides the graphical display of the lines
 	void		setGraphicalDisplayHidden(bool status);
-	// scales the central guidance magnetic force by the scale factor in CommonValues
-	void		scaleForce();
 	// sets the red line representing the magnetic line transparent
 	void		setLineAsTransparent(bool status);
 
@@ -82,10 +102,14 @@ public:
 	void		setB(cVector3d B);
 	void		setVector(cVector3d A, cVector3d B);
 	void		setGuidance(bool status);
+	void		setSegmentIndex(int segmentIndex);
 
 	cVector3d	getA();
 	cVector3d	getB();
 	cVector3d	getVector();
 	cShapeLine*	getLineShape();
 	bool		getGuidance();
+	// the drawn tool is turned from the x axis onto the line by the graphics thread (see applySnapshot)
+	cMatrix3d	getToolAlignment();
+	int			getSegmentIndex();
 };
\ No newline at end of file
@@ -21,6 +21,8 @@ Qatar University
 //=========================================================*/
 // ---------------- singleton class instance
 CommonValues*			values;
+ModuleRunner*			runner;
+SessionService*			session;
 
 // ---------------- basic variables for the scene
 cCamera*				camera;
@@ -56,6 +58,54 @@ Point*					createdPoints = NULL;
 MagneticLine*			createdLines = NULL;
 VFBlock*				createdVFBlocks = NULL;
 Corner*					createdCorners = NULL;
+cShapeSphere*			createdStartingPoint = NULL;
+PathArena*				pathArena = NULL;			// build thread only; owns the path being built
+
+// ---------------- fixtures seen by the haptic loop (set once the path is attached)
+ContactEventStream		contactEvents;				// haptic thread only
+vector<MagneticLine*>	activeLines;				// haptic thread only; lines whose guidance is on
+FixtureSet*				activeFixtureSet = NULL;	// haptic thread only
+FixturePipelineFunction	updateFixtures = NULL;		// haptic thread only
+
+// ---------------- asynchronous startup
+WorkerGroup				modelLoading;
+cMesh*					drill = NULL;
+ProgressiveFieldBaker*	anatomyFieldBaker = NULL;	// set before the haptic loop starts, if the model has walls
+string					modelFileName;
+cLabel*					loadingLabel;
+volatile long			isDrillLoaded		= 0;
+volatile long			isModelLoaded		= 0;
+volatile long			areFixturesBuilt	= 0;
+volatile long			loadingStepsDone	= 0;
+volatile long			loadingStepsTotal	= 0;
+bool					isDrillAttached		= false;	// haptic thread only
+bool					isModelAttached		= false;	// haptic thread only
+bool					areFixturesAttached	= false;	// haptic thread only
+bool					isSceneRefreshNeeded = true;		// haptic thread only; the structure of the scene changed
+bool					isLoadingFinished	= false;	// graphics thread only
+
+// ---------------- walls of the anatomy (haptic thread only)
+SignedDistanceField*	anatomyWalls		= NULL;		// the latest level of the field of the model, for this tick
+double					anatomyFreeSide		= 1;		// +1 if the path runs outside the model, -1 inside
+
+// ---------------- graphics/haptics decoupling
+FramePacer*				framePacer;
+bool					isFrameTimerPending	= false;	// graphics thread only
+const int				SCENE_TIMER_PERIOD	= 10;		// [ms] between two applications of the scene changes outside the frames
+SnapshotBuffer			snapshotBuffer;
+unsigned long			hapticTick				= 0;	// haptic thread only
+long					lastCollisionQueries	= 0;	// counters of the trees at the last snapshot (haptic thread only)
+long					lastVisitedNodes		= 0;
+long					lastTestedTriangles		= 0;
+
+// ---------------- tool alignment (graphics thread only)
+const double			TOOL_ALIGNMENT_TIME	= 0.05;		// [s] time constant of the turn towards a line
+cPrecisionClock			alignmentClock;
+double					lastAlignmentTime	= 0;
+cQuaternion				drillRotation;
+cQuaternion				drillTargetRotation;
+cMatrix3d				drillAxisAlignment;				// turns the axis of the drill onto the x axis
+bool					isDrillPosed		= false;
 
 cVector3d startingPointPos;
 
@@ -65,6 +115,7 @@ cVector3d startingPointPos;
 
 // ---------------- program startup methods
 void					setupEnvironment(void);
+bool					parseModuleArguments(int, char**);
 void					initializeValues(void);
 void					printInstructions(void);
 void					initializeScene(void);
@@ -81,9 +132,28 @@ void					close(void);
 void					addStartingPointGuide(void);
 void					setStartingPointStatus(bool status);
 
+// ---------------- asynchronous startup methods
+void					startLoading(void);
+void					loadDrill(void);
+void					loadDrillTask(void* arg);
+void					loadModelTask(void* arg);
+void					bakeAnatomyFieldTask(void* arg);
+void					buildFixturesTask(void* arg);
+void					attachLoadedAssets(void);
+void					attachFixtureSet(FixtureSet* fixtureSet);
+void					detachFixtureSet(void);
+void					runModulesTask(void);
+void					updateLoadingLabel(void);
+
 // ---------------- update methods
 void					updateGraphics(void);
+void					onFrameTimer(int value);
+void					onSceneTimer(int value);
+void					applySnapshot(HapticSnapshot snapshot);
 void					updateHaptics(void);
+void					publishSnapshot(void);
+cVector3d				computeAnatomyWallForce(cVector3d position);
+void					updateAnatomyFreeSide(void);
 void					updateCameraPosition(void);
 void					startSimulation(void);
 
@@ -91,7 +161,7 @@ void					startSimulation(void);
 // this method is to be replaced with the output of mesh skeleton extraction
 void					createPoints(void); 
 void					createMagneticLinesFromPoints(Point* pointsHead);
-void					createVFBlocksFromMagneticLines(MagneticLine* linesHead);
+void					createVFBlocksFromMagneticLines(MagneticLine* linesHead, FixtureWindow* window);
 
 // ---------------- algorithm methods - visual
 void					setHideBlocks(bool status, VFBlock* blocksHead);
@@ -103,6 +173,9 @@ void					printLines(MagneticLine* linesHead);
 
 // ---------------- algorithm methods - utilities
 double					getAngleBetweenLines(MagneticLine* prevline, MagneticLine* line);
+int						countSceneNodes(cGenericObject* node, int& numCollisionMeshes);
+void					setObjectStiffness(cGenericObject* node, double stiffness);
+void					printCollisionStatistics(void);
 
 
 
@@ -122,22 +195,19 @@ int main(int argc, char* argv[])
 	pointsMode = READ_FROM_FILE;
 
 	values = CommonValues::getInstance();
+	runner = ModuleRunner::getInstance();
+	session = SessionService::getInstance();
 
-	values->isTutorialModule = true;
-	//values->V = false;
-	//values->G = false;
-	//values->F = false;
-
-	values->moduleName = "TUTORIAL";
+	// the modules to run in this session; the tutorial if none is given
+	if(!parseModuleArguments(argc, argv))
+		return (1);
 
 	setupEnvironment();
 	setupGlutSettings(argc, argv);
- 
-	if(pointsMode == LOADED_MODEL)loadModel();
-	createPoints();
 
-	createMagneticLinesFromPoints(createdPoints);
-	createVFBlocksFromMagneticLines(createdLines);	
+	// the drill, the model and the path fixtures are built on the worker pool
+	// while the window is up and the haptic loop is already running
+	startLoading();
 
 	startSimulation();
 
@@ -151,11 +221,127 @@ int main(int argc, char* argv[])
 
 void setupEnvironment(void)
 {
-	printInstructions();
+	// the instructions are printed by the runner when each module starts
 	initializeValues();
 	initializeScene();
-	initializeHapticTool();	
-	defineStandardRadius();
+	initializeHapticTool();
+}
+
+//=========================================================//
+
+bool parseModuleArguments(int argc, char** argv)
+{
+	ModuleConfig config;
+	string lawPrefix = "law=";
+	string trialsPrefix = "trials=";
+	string wallsPrefix = "walls=";
+	string guidancePrefix = "guidance=";
+	string anatomyPrefix = "anatomy=";
+	string windowPrefix = "window=";
+	string fpsPrefix = "fps=";
+
+	for(int i=1; i<argc; i++)
+	{
+		string argument = argv[i];
+
+		// the guidance force law: law=magnet|linear|exponential|spring-damper|table:<file>
+		if(argument.compare(0, lawPrefix.length(), lawPrefix) == 0)
+		{
+			GuidanceForceLaw* law = GuidanceForceLaw::create(argument.substr(lawPrefix.length()));
+			if(law == NULL)
+			{
+				printf("Unknown force law [%s].\n", argument.c_str());
+				return false;
+			}
+			delete values->guidanceForceLaw;
+			values->guidanceForceLaw = law;
+		}
+		// the number of timed trials of every testing module: trials=<n>
+		else if(argument.compare(0, trialsPrefix.length(), trialsPrefix) == 0)
+		{
+			int numOfTrials = atoi(argument.substr(trialsPrefix.length()).c_str());
+			if(numOfTrials < 1)
+			{
+				printf("Invalid number of trials [%s].\n", argument.c_str());
+				return false;
+			}
+			values->numOfTrials = numOfTrials;
+		}
+		// what the tool collides with: walls=fixtures|anatomy|both
+		else if(argument.compare(0, wallsPrefix.length(), wallsPrefix) == 0)
+		{
+			string walls = argument.substr(wallsPrefix.length());
+			if(walls != "fixtures" && walls != "anatomy" && walls != "both")
+			{
+				printf("Unknown walls [%s]. Expected fixtures, anatomy or both.\n", argument.c_str());
+				return false;
+			}
+			values->areFixtureWallsEnabled = (walls != "anatomy");
+			values->areAnatomyWallsEnabled = (walls != "fixtures");
+		}
+		// where the guidance comes from: guidance=magnets|field
+		else if(argument.compare(0, guidancePrefix.length(), guidancePrefix) == 0)
+		{
+			string guidance = argument.substr(guidancePrefix.length());
+			if(guidance != "magnets" && guidance != "field")
+			{
+				printf("Unknown guidance [%s]. Expected magnets or field.\n", argument.c_str());
+				return false;
+			}
+			values->isGuidanceFieldEnabled = (guidance == "field");
+		}
+		// how the walls of the model are felt: anatomy=field|mesh
+		else if(argument.compare(0, anatomyPrefix.length(), anatomyPrefix) == 0)
+		{
+			string anatomy = argument.substr(anatomyPrefix.length());
+			if(anatomy != "field" && anatomy != "mesh")
+			{
+				printf("Unknown anatomy walls [%s]. Expected field or mesh.\n", argument.c_str());
+				return false;
+			}
+			values->isAnatomyMeshCollisionEnabled = (anatomy == "mesh");
+		}
+		// only the fixtures near the tool are in the scene: window=<arc length in block heights>, 0 for all
+		else if(argument.compare(0, windowPrefix.length(), windowPrefix) == 0)
+		{
+			double windowLength = atof(argument.substr(windowPrefix.length()).c_str());
+			if(windowLength < 0)
+			{
+				printf("Invalid fixture window [%s].\n", argument.c_str());
+				return false;
+			}
+			values->fixtureWindowLength = windowLength;
+		}
+		// the graphics frame rate: fps=<frames per second>, 0 for unlimited
+		else if(argument.compare(0, fpsPrefix.length(), fpsPrefix) == 0)
+		{
+			double frameRate = atof(argument.substr(fpsPrefix.length()).c_str());
+			if(frameRate < 0)
+			{
+				printf("Invalid frame rate [%s].\n", argument.c_str());
+				return false;
+			}
+			values->targetFrameRate = frameRate;
+		}
+		// the whole experiment: optional tutorial, then the testing modules in random order
+		else if(argument == "experiment")
+			runner->planExperiment();
+		else if(ModuleRunner::getModuleConfig(argument, config))
+			runner->addModule(config);
+		else
+		{
+			printf("Unknown module [%s]. Expected V, FV, GV, FG, COM, TUTORIAL or experiment.\n", argv[i]);
+			return false;
+		}
+	}
+
+	if(runner->getNumModules() == 0)
+	{
+		ModuleRunner::getModuleConfig("TUTORIAL", config);
+		runner->addModule(config);
+	}
+
+	return true;
 }
 
 //=========================================================//
@@ -173,6 +359,8 @@ void initializeValues(void)
 	simulationFinished = false;
 	displayW = 0;
 	displayH = 0;
+
+	framePacer = new FramePacer(values->targetFrameRate);
 }
 
 //=========================================================//
@@ -182,7 +370,7 @@ void printInstructions(void)
 	cout<<"Module ["<<values->moduleName<<"]"<<endl;
 	if(!values->isTutorialModule){
 		cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-		cout<<"Please move through the path 3 times, each time with a different view.\n";
+		cout<<"Please move through the path "<<values->numOfTrials<<" times, each time with a different view.\n";
 		cout<<"In case of errors, press [r] to repeat the module.\n";
 		cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
 		cout<<"Trial #"<<values->trials<<endl;
@@ -191,6 +379,8 @@ void printInstructions(void)
 		cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
 		cout<<"You can change the camera orientation with:\n[1] The haptic middle switch, or"<<endl;
 		cout<<"[2] The mouse: \n  Left click + drag: rotates across X and Y\n  Right click + drag: moves across Z (depth)"<<endl;
+		if(!runner->isLastModule())
+			cout<<"Press [x] when you are ready to continue to the next module."<<endl;
 		cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
 	}
 }
@@ -213,7 +403,29 @@ void initializeScene(void)
     camera->addChild(light);                   
     light->setEnabled(true);                   
     light->setPos(cVector3d( 2.0, 0.5, 1.0));  
-    light->setDir(cVector3d(-2.0, 0.5, 1.0));  
+    light->setDir(cVector3d(-2.0, 0.5, 1.0));
+
+	// the path fixtures are built under this node and attached all at once
+	values->fixtureRoot = new cGenericObject();
+	values->fixtureCollisionRoot = new cGenericObject();
+
+	// the proxy only checks the nodes under this one, i.e. the walls and caps of the fixtures;
+	// the model, the drill, the tool and the shapes never reach its narrowphase
+	values->collisionWorld = new cWorld();
+	values->world->addChild(values->collisionWorld);
+
+	// visual changes requested by the haptic thread, applied at the start of each frame
+	values->sceneCommands = new SceneCommandQueue(1024);
+
+	// trial events for the session service; the haptic loop never waits on I/O
+	values->sessionEvents = new SessionEventQueue(1024);
+
+	// progress of the asynchronous startup, hidden once everything is attached
+	loadingLabel = new cLabel();
+	camera->m_front_2Dscene.addChild(loadingLabel);
+	loadingLabel->setPos(10, 10, 0);
+	loadingLabel->m_fontColor.set(1.0, 1.0, 1.0);
+	loadingLabel->m_string = "Loading... 0%";
 
 	values->cameraAngleH = 0;
     values->cameraAngleV = 45;
@@ -247,16 +459,24 @@ void initializeHapticTool(void)
 
     values->tool->m_proxyPointForceModel->setProxyRadius(values->proxyRadius);
     values->tool->m_proxyPointForceModel->m_collisionSettings.m_checkBothSidesOfTriangles = true;
+	values->tool->m_proxyPointForceModel->initialize(values->collisionWorld, values->tool->getDeviceGlobalPos());
 
 	workspaceScaleFactor = values->tool->getWorkspaceScaleFactor();
 	values->stiffnessMax = info.m_maxForceStiffness / workspaceScaleFactor;
 	values->forceMax = info.m_maxForce;
 
-	if(values->F)values->cylinderStiffness = 0.4 * values->stiffnessMax;
-	else values->cylinderStiffness = 0;
+	// placed on the drill tip once the drill is attached
+	values->toolTipEndSphere = new cShapeSphere(0.001);
+	values->tool->m_proxyMesh->addChild(values->toolTipEndSphere);
 
+	values->toolTipOriginalOrientation = values->tool->m_proxyMesh->getRot();
+}
+
+//=========================================================//
 
-    cMesh* drill = new cMesh(values->world);
+void loadDrill(void)
+{
+    drill = new cMesh(values->world);
 	bool fileload;
 	string resourceRoot = "../resources/drill.3ds";
 
@@ -290,16 +510,7 @@ void initializeHapticTool(void)
     drill->setMaterial(mat, true);
     drill->computeAllNormals(true);
 
-
-    // attach drill to tool
-    values->tool->m_proxyMesh->addChild(drill);
-	values->tool->m_proxyMesh->setFrameSize(0.5, 0.3, true);
-
-	values->toolTipEndSphere = new cShapeSphere(0.001);
-	values->tool->m_proxyMesh->addChild(values->toolTipEndSphere);
-	values->toolTipEndSphere->setPos(values->tool->m_proxyMesh->pVerticesNonEmpty()->at(0).getPos());
-
-	values->toolTipOriginalOrientation = values->tool->m_proxyMesh->getRot();
+	// the drill is attached to the tool by attachLoadedAssets()
 }
 
 //=========================================================//
@@ -309,10 +520,16 @@ void defineStandardRadius(void)
 	// the code below in this method is only for testing purposes
 	// however it is important to set up the initial values of stdBlockHeight and stdBlockRadius
 	// as they will be used a lot throughout the program
-	VFBlock* testBlock = new VFBlock();
+	PathArena scratch;
+	VFBlock* testBlock = scratch.create<VFBlock>();
 	values->stdBlockRadius = testBlock->getRadius();
 	values->stdBlockHeight = testBlock->getHeight();
 	testBlock->removeFromWorld();
+
+	// the block goes with the scratch arena
+	scratch.adopt(testBlock->getCylinderMesh());
+	scratch.adopt(testBlock->getTopMesh());
+	scratch.adopt(testBlock->getBottomMesh());
 }
 
 //=========================================================//
@@ -360,6 +577,13 @@ void keySelect(unsigned char key, int x, int y)
     // escape key
     if ((key == 27) || (key == 'x'))
     {
+		// the tutorial has no trials; leaving it moves on to the next module
+		if(values->isTutorialModule && !runner->isLastModule())
+		{
+			session->requestModuleEnd();
+			return;
+		}
+
         // close everything
         close();
 
@@ -373,15 +597,17 @@ void keySelect(unsigned char key, int x, int y)
 		values->tool->getDeviceGlobalPos().print();
 	}
 
+	if(key=='f')
+	{
+		framePacer->printStatistics();
+		framePacer->resetStatistics();
+		printCollisionStatistics();
+	}
+
 	if(key=='r')
 	{	
-		if(!values->isTutorialModule){
-			values->trials = 1;
-			cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-			printf("Number of trials is reset\n");
-			cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
-			printf("Trial # %d\n", values->trials);
-		}
+		// the trials are counted by the session service
+		session->requestTrialReset();
 	}
 
 }
@@ -450,6 +676,15 @@ void close(void)
 
 void updateGraphics(void)
 {
+	framePacer->beginFrame();
+
+	// scene changes requested by the haptic thread since the last frame
+	values->sceneCommands->applyAll();
+	// everything drawn from haptic state in this frame comes from one tick
+	applySnapshot(snapshotBuffer.read());
+	updateLoadingLabel();
+	updateCameraPosition();
+
     camera->renderView(displayW, displayH);
 
     glutSwapBuffers();
@@ -458,14 +693,89 @@ void updateGraphics(void)
     err = glGetError();
     if (err != GL_NO_ERROR) printf("Error:  %s\n", gluErrorString(err));
 
-    if (simulationRunning)
+	framePacer->endFrame();
+
+	// wait for the next frame slot instead of redrawing right away; a redisplay asked for by
+	// GLUT itself (reshape, expose) must not start a second chain of timers
+    if (simulationRunning && !isFrameTimerPending)
     {
-        glutPostRedisplay();
+		isFrameTimerPending = true;
+        glutTimerFunc(framePacer->getMillisecondsToNextFrame(), onFrameTimer, 0);
     }
 }
 
 //=========================================================//
 
+void onFrameTimer(int value)
+{
+	isFrameTimerPending = false;
+	glutPostRedisplay();
+}
+
+//=========================================================//
+
+void onSceneTimer(int value)
+{
+	// GLUT does not draw a minimised window, and the haptic loop holds the device at zero
+	// force until its scene changes are applied; they are applied here as well, whether or
+	// not a frame is drawn
+	values->sceneCommands->applyAll();
+
+	if (simulationRunning)
+		glutTimerFunc(SCENE_TIMER_PERIOD, onSceneTimer, 0);
+}
+
+//=========================================================//
+
+void applySnapshot(HapticSnapshot snapshot)
+{
+	// the drill is only a visual, so it follows the proxy pose of the snapshot
+	// rather than being moved by the haptic thread in the middle of a frame
+	if(drill != NULL && snapshot.tick > 0)
+	{
+		drill->setPos(snapshot.proxyGlobalPos);
+
+		if(!isDrillPosed)
+		{
+			drill->setRot(snapshot.proxyGlobalRot);
+			if(!atomicLoad(&isDrillLoaded))
+				return;
+
+			// the axis of the drill runs from its tip, the first vertex, to its origin
+			cVector3d axis = cVector3d(0,0,0) - drill->pVerticesNonEmpty()->at(0).getPos();
+			drillAxisAlignment = MagneticLine::getRotationBetween(axis, cVector3d(1,0,0));
+			drillRotation.fromRotMat(snapshot.proxyGlobalRot);
+			drillTargetRotation = drillRotation;
+			alignmentClock.reset();
+			alignmentClock.start();
+			lastAlignmentTime = 0;
+			isDrillPosed = true;
+		}
+
+		// while the guidance of a line is on, the drill turns to lie along it and keeps
+		// that orientation afterwards; the turn depends on the time, not on the frame rate
+		if(snapshot.isToolAligning)
+		{
+			cMatrix3d target;
+			snapshot.toolAlignment.mulr(drillAxisAlignment, target);
+			drillTargetRotation.fromRotMat(target);
+		}
+
+		double now	= alignmentClock.getCurrentTimeSeconds();
+		double step	= 1.0 - exp(-(now - lastAlignmentTime) / TOOL_ALIGNMENT_TIME);
+		lastAlignmentTime = now;
+
+		cQuaternion current = drillRotation;
+		drillRotation.slerp(step, current, drillTargetRotation);
+
+		cMatrix3d rotation;
+		drillRotation.toRotMat(rotation);
+		drill->setRot(rotation);
+	}
+}
+
+//=========================================================//
+
 void updateCameraPosition()
 {
    // check values
@@ -506,9 +816,17 @@ void startSimulation()
 {
     simulationRunning = true;
 
+	// a path has at most a couple of lines on at once; no allocation in the haptic loop
+	activeLines.reserve(8);
+
     cThread* hapticsThread = new cThread();
     hapticsThread->set(updateHaptics, CHAI_THREAD_PRIORITY_HAPTICS);
 
+	// hands the modules to the haptic loop one after the other
+	cThread* runnerThread = new cThread();
+	runnerThread->set(runModulesTask, CHAI_THREAD_PRIORITY_GRAPHICS);
+
+	glutTimerFunc(SCENE_TIMER_PERIOD, onSceneTimer, 0);
     glutMainLoop();
 
     close();
@@ -518,19 +836,52 @@ void startSimulation()
 
 void updateHaptics(void)
 {
-	MagneticLine* tempLines = createdLines;
-	VFBlock* tempBlocks = createdVFBlocks;
-	Corner* tempCorners = createdCorners;
-
     while(simulationRunning)
     {
-		values->world->computeGlobalPositions(true);
+		attachLoadedAssets();
+
+		// the graphics thread is adding nodes to the world; keep off the scene graph
+		// until it has done so (at most one frame, during startup or when a fixture set
+		// is attached or detached between modules)
+		if(values->sceneCommands->isStructureChangePending())
+		{
+			isSceneRefreshNeeded = true;
+			values->tool->m_lastComputedGlobalForce.zero();
+			values->tool->applyForces();
+			continue;
+		}
+
+		// the module has ended; the device is held at zero force while the session
+		// service talks to the tester, until the next module is attached
+		if(session->getIsParkRequested())
+		{
+			if(areFixturesAttached)
+				detachFixtureSet();
+
+			values->tool->updatePose();
+			values->tool->m_lastComputedGlobalForce.zero();
+			values->tool->applyForces();
+			publishSnapshot();
+			session->notifyParked();
+			continue;
+		}
+
+		// only the tool moves from tick to tick; the rest of the scene, the whole path
+		// included, is refreshed once after the graphics thread has changed its structure
+		if(isSceneRefreshNeeded)
+		{
+			values->world->computeGlobalPositions(true);
+			isSceneRefreshNeeded = false;
+		}
+		else
+			values->tool->computeGlobalPositions(true);
 		values->tool->updatePose();
 		values->tool->computeInteractionForces();
 
-		toolLocalPos  = values->tool->getDeviceLocalPos();
+		// every event of this tick carries the same time stamp
+		values->hapticTime = getMonotonicNanoseconds();
 
-		values->toolTipEndSphere->setPos(values->tool->m_proxyMesh->pVerticesNonEmpty()->at(0).getPos());
+		toolLocalPos  = values->tool->getDeviceLocalPos();
 
 
 		if(values->tool->getUserSwitch(0))
@@ -544,49 +895,449 @@ void updateHaptics(void)
             values->cameraAngleV = values->cameraAngleV - 40 * offset.z;  
 		}
 
-		updateCameraPosition(); 
+		// the camera itself is moved by the graphics thread at the start of the next frame
 
 		prevToolLocalPos  = toolLocalPos;
 
-		tempLines = createdLines;
-		while( tempLines!=NULL )
+		// the fixtures and the starting point only exist once the path is attached
+		if(areFixturesAttached)
 		{
-			tempLines->updateHaptics();
-			tempLines = tempLines->next;   
+			values->pathProgress->update(values->tool->getProxyGlobalPos());
+
+			// only the fixtures near the tool are enabled; nothing to wait for
+			if(activeFixtureSet->window.update(values->pathProgress->getSegment(), values->sceneCommands))
+			{
+				activeFixtureSet->numCollisionNodes		= 1 + activeFixtureSet->window.getNumCollisionNodes();
+				activeFixtureSet->numCollisionMeshes	= activeFixtureSet->window.getNumCollisionMeshes();
+			}
+
+			// the pipeline of the running module, without the highlight or the magnets it does not use
+			contactEvents.update(values->tool);
+			updateFixtures(&contactEvents, activeLines);
+
+			// the baked guidance, while the tool is inside the path
+			if(values->guidanceField != NULL && !activeLines.empty())
+				values->tool->m_lastComputedGlobalForce.add(values->guidanceField->getForce(values->tool->getDeviceGlobalPos()));
+
+			if(values->isInsideThePath)
+			{
+				if(!startingPoint->getAsGhost())
+					setStartingPointStatus(false);
+			}else
+			{
+				if(startingPoint->getAsGhost())
+					setStartingPointStatus(true);
+			}
 		}
 
-		tempBlocks = createdVFBlocks;
-		while( tempBlocks!=NULL )
+		// the surface of the model, alongside or instead of the walls of the fixtures
+		if(anatomyWalls != NULL)
+			values->tool->m_lastComputedGlobalForce.add(computeAnatomyWallForce(values->tool->getDeviceGlobalPos()));
+
+		values->tool->applyForces();
+
+		publishSnapshot();
+		session->notifyEventsQueued();
+    }
+    
+    // exit haptics thread; the session service may be waiting for it to park
+	session->notifyStopped();
+    simulationFinished = true;
+}
+
+//=========================================================//
+
+void publishSnapshot(void)
+{
+	HapticSnapshot* snapshot = snapshotBuffer.beginWrite();
+
+	snapshot->tick					= ++hapticTick;
+	snapshot->proxyGlobalPos		= values->tool->getProxyGlobalPos();
+	snapshot->proxyGlobalRot		= values->tool->m_proxyMesh->getGlobalRot();
+	snapshot->deviceGlobalPos		= values->tool->getDeviceGlobalPos();
+	snapshot->force					= values->tool->m_lastComputedGlobalForce;
+	snapshot->areFixturesAttached	= areFixturesAttached;
+	snapshot->isInsideThePath		= values->isInsideThePath;
+	snapshot->numOfCollisions		= values->numOfCollisions;
+	snapshot->trials				= values->trials;
+	// the proxy visits the collision scene itself and, once attached, the meshes of the set
+	snapshot->numCollisionNodes		= 1;
+	snapshot->numCollisionMeshes	= 0;
+	if(activeFixtureSet != NULL)
+	{
+		snapshot->numCollisionNodes		+= activeFixtureSet->numCollisionNodes;
+		snapshot->numCollisionMeshes	+= activeFixtureSet->numCollisionMeshes;
+	}
+	snapshot->numCollisionQueries	= MeshCollisionBVH::getNumQueries();
+	snapshot->numCollisionCacheHits	= MeshCollisionBVH::getNumCacheHits();
+	snapshot->numVisitedNodes		= MeshCollisionBVH::getNumVisitedNodes();
+	snapshot->numTestedTriangles	= MeshCollisionBVH::getNumTestedTriangles();
+
+	// a snapshot is published once per tick, so the counters moved this much in it
+	snapshot->tickCollisionQueries	= (int)(snapshot->numCollisionQueries - lastCollisionQueries);
+	snapshot->tickVisitedNodes		= (int)(snapshot->numVisitedNodes - lastVisitedNodes);
+	snapshot->tickTestedTriangles	= (int)(snapshot->numTestedTriangles - lastTestedTriangles);
+	lastCollisionQueries			= snapshot->numCollisionQueries;
+	lastVisitedNodes				= snapshot->numVisitedNodes;
+	lastTestedTriangles				= snapshot->numTestedTriangles;
+	snapshot->isToolAligning		= !activeLines.empty();
+	if(snapshot->isToolAligning)
+		snapshot->toolAlignment		= activeLines.back()->getToolAlignment();
+	if(values->pathProgress != NULL)
+	{
+		snapshot->pathSegment		= values->pathProgress->getSegment();
+		snapshot->pathProgress		= values->pathProgress->getProgress();
+		snapshot->pathDeviation		= values->pathProgress->getDeviation();
+	}
+	else
+	{
+		snapshot->pathSegment		= 0;
+		snapshot->pathProgress		= 0;
+		snapshot->pathDeviation		= 0;
+	}
+
+	snapshotBuffer.endWrite();
+}
+
+//=========================================================//
+
+cVector3d computeAnatomyWallForce(cVector3d position)
+{
+	double		distance;
+	cVector3d	gradient;
+	if(!anatomyWalls->getDistance(position, distance, gradient))
+		return cVector3d(0, 0, 0);
+
+	// how far the proxy sphere is into the wall, seen from the side of the path; beyond the
+	// band the field is flat and there is no direction to push to
+	double penetration = values->proxyRadius - anatomyFreeSide * distance;
+	if(penetration <= 0 || gradient.length() == 0)
+		return cVector3d(0, 0, 0);
+
+	gradient.normalize();
+	double force = cMin(0.4 * values->stiffnessMax * penetration, values->forceMax);
+	return gradient * (anatomyFreeSide * force);
+}
+
+//=========================================================//
+
+void updateAnatomyFreeSide(void)
+{
+	// the path starts in the free space of the model: inside a vessel or around an organ
+	if(anatomyWalls == NULL || activeFixtureSet == NULL)
+		return;
+
+	double		distance;
+	cVector3d	gradient;
+	if(anatomyWalls->getDistance(activeFixtureSet->startingPoint->getPos(), distance, gradient) && distance < 0)
+		anatomyFreeSide = -1;
+	else
+		anatomyFreeSide = 1;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================ASYNCHRONOUS STARTUP METHODS===========//
+//=========================================================*/
+
+void startLoading(void)
+{
+	WorkerPool* pool = WorkerPool::getInstance();
+
+	// the model is also needed for its walls
+	bool isModelNeeded = (pointsMode == LOADED_MODEL) || values->areAnatomyWallsEnabled;
+
+	// drill + standard radius + points and lines (+ model); one step per block is added later.
+	// The distance field of the model is refined in the background and does not hold the start
+	atomicStore(&loadingStepsTotal, isModelNeeded ? 4 : 3);
+	if(values->areAnatomyWallsEnabled && !values->isAnatomyMeshCollisionEnabled)
+		anatomyFieldBaker = new ProgressiveFieldBaker();
+
+	pool->submit(loadDrillTask, NULL);
+	if(isModelNeeded)
+		pool->submit(loadModelTask, NULL, &modelLoading);
+	pool->submit(buildFixturesTask, NULL);
+}
+
+//=========================================================//
+
+void loadDrillTask(void* arg)
+{
+	loadDrill();
+
+	atomicIncrement(&loadingStepsDone);
+	atomicStore(&isDrillLoaded, 1);
+}
+
+//=========================================================//
+
+void loadModelTask(void* arg)
+{
+	loadModel();
+
+	// baked on its own, so that building the fixtures does not wait for it
+	if(anatomyFieldBaker != NULL)
+		WorkerPool::getInstance()->submit(bakeAnatomyFieldTask, NULL);
+
+	atomicIncrement(&loadingStepsDone);
+	atomicStore(&isModelLoaded, 1);
+}
+
+//=========================================================//
+
+void bakeAnatomyFieldTask(void* arg)
+{
+	// the model is not moved once loaded, so its frame is the frame of the world; the band
+	// only needs to hold the proxy and how deep it can be pushed into a wall, and the
+	// number of bricks kept grows with it
+	anatomyFieldBaker->bake(model, values->anatomyFieldResolution, 2 * values->proxyRadius, modelFileName + ".sdf");
+}
+
+//=========================================================//
+
+void buildFixturesTask(void* arg)
+{
+	// everything built here goes under values->fixtureRoot, which is not in the world yet,
+	// so neither the haptic nor the graphics thread can see a half-built path
+	defineStandardRadius();
+	atomicIncrement(&loadingStepsDone);
+
+	// the midpoints of a loaded model are extracted from its vertices
+	if(pointsMode == LOADED_MODEL)
+		WorkerPool::getInstance()->wait(&modelLoading);
+
+	// one fixture set per module, in running order; the lines and blocks read the
+	// module's settings from CommonValues while they are being constructed
+	for(int i=0; i<runner->getNumModules(); i++)
+	{
+		FixtureSet* fixtureSet = runner->getFixtureSet(i);
+
+		// everything below is owned by the arena of the set, and deleted with it once the
+		// module has run (see runModulesTask)
+		pathArena					= &fixtureSet->arena;
+		fixtureSet->root			= pathArena->adopt(new cGenericObject());
+		fixtureSet->collisionRoot	= pathArena->adopt(new cGenericObject());
+
+		values->V				= fixtureSet->config.V;
+		values->F				= fixtureSet->config.F;
+		values->G				= fixtureSet->config.G;
+		values->pointsFileName	= fixtureSet->config.pointsFileName;
+		values->fixtureRoot		= fixtureSet->root;
+		values->fixtureCollisionRoot	= fixtureSet->collisionRoot;
+
+		if(values->F && values->areFixtureWallsEnabled)values->cylinderStiffness = 0.4 * values->stiffnessMax;
+		else values->cylinderStiffness = 0;
+
+		createPoints();
+		createMagneticLinesFromPoints(createdPoints);
+		if(i == 0)
+			atomicAdd(&loadingStepsTotal, (long)values->numOfMidPoints - 1);
+		atomicIncrement(&loadingStepsDone);
+
+		// the polyline the progress of the tool is measured on; the fixtures of each of its
+		// segments are built under nodes of their own, so that they can be streamed
+		fixtureSet->progress.build(createdPoints, (int)values->numOfMidPoints);
+		fixtureSet->window.createGroups(&fixtureSet->progress, fixtureSet->root, fixtureSet->collisionRoot);
+
+		createVFBlocksFromMagneticLines(createdLines, &fixtureSet->window);
+		values->fixtureRoot				= fixtureSet->root;
+		values->fixtureCollisionRoot	= fixtureSet->collisionRoot;
+
+		// the split times of the trials are recorded per line
+		int segmentIndex = 0;
+		for(MagneticLine* line = createdLines; line != NULL; line = line->next)
+			line->setSegmentIndex(segmentIndex++);
+
+		// the guidance of the whole path, in place of the magnets of the lines
+		if(values->G && values->isGuidanceFieldEnabled)
 		{
-			tempBlocks->updateHaptics();
-			tempBlocks = tempBlocks->next;   
+			double pullForce = 0.3 * values->forceMax * values->forceScaleFactor;
+			double pushForce = 0.4 * values->forceMax * values->forceScaleFactor;
+			if(!fixtureSet->guidanceField.bake(createdPoints, (int)values->numOfMidPoints, values->guidanceForceLaw,
+				pullForce, pushForce, values->stdBlockRadius, 0.4 * values->stiffnessMax))
+				printf("Error - the guidance field of module %s could not be baked.\n", fixtureSet->config.name.c_str());
 		}
 
-		tempCorners = createdCorners;
-		while( tempCorners!=NULL )
+		// the meshes the haptic loop reports contacts for
+		for(MagneticLine* line = createdLines; line != NULL; line = line->next)
+			line->subscribeContacts(fixtureSet->contactSubscriptions);
+		for(VFBlock* block = createdVFBlocks; block != NULL; block = block->next)
+			block->subscribeContacts(fixtureSet->contactSubscriptions);
+		for(Corner* corner = createdCorners; corner != NULL; corner = corner->next)
+			corner->subscribeContacts(fixtureSet->contactSubscriptions);
+
+		// all the groups in the scene, or only those around the starting point
+		for(int g=0; g<fixtureSet->window.getNumGroups(); g++)
 		{
-			tempCorners->updateHaptics();
-			tempCorners = tempCorners->next;   
+			FixtureGroup* group = fixtureSet->window.getGroup(g);
+			group->numCollisionNodes = countSceneNodes(group->collisionRoot, group->numCollisionMeshes);
 		}
+		fixtureSet->window.materialize(values->fixtureWindowLength > 0, values->fixtureWindowLength * values->stdBlockHeight);
+
+		fixtureSet->lines			= createdLines;
+		fixtureSet->vfBlocks		= createdVFBlocks;
+		fixtureSet->corners			= createdCorners;
+		fixtureSet->startingPoint	= createdStartingPoint;
+		fixtureSet->numOfMidPoints	= values->numOfMidPoints;
+		fixtureSet->numCollisionNodes	= countSceneNodes(fixtureSet->collisionRoot, fixtureSet->numCollisionMeshes);
+		fixtureSet->built.set();
+
+		// the first module can start while the others are still being built
+		if(i == 0)
+			atomicStore(&areFixturesBuilt, 1);
+	}
+}
 
-		if(values->isInsideThePath)
-		{
-			if(!startingPoint->getAsGhost())
-				setStartingPointStatus(false);
-		}else
+//=========================================================//
+
+void attachLoadedAssets(void)
+{
+	// called by the haptic thread at the start of each tick
+
+	if(!isDrillAttached && atomicLoad(&isDrillLoaded))
+	{
+		// the tip end is fixed in the proxy frame, at the first vertex of the drill
+		values->toolTipEndSphere->setPos(drill->pVerticesNonEmpty()->at(0).getPos());
+
+		// the drill hangs from the world and is posed by the graphics thread (see applySnapshot)
+		values->sceneCommands->addChild(values->world, drill);
+		values->tool->m_proxyMesh->setFrameSize(0.5, 0.3, true);
+		isDrillAttached = true;
+	}
+
+	if(!isModelAttached && atomicLoad(&isModelLoaded))
+	{
+		// the proxy only sees the model if it collides with its triangles
+		if(values->areAnatomyWallsEnabled && values->isAnatomyMeshCollisionEnabled)
+			values->sceneCommands->addChild(values->collisionWorld, model);
+		else
+			values->sceneCommands->addChild(values->world, model);
+		isModelAttached = true;
+	}
+
+	// a finer level of the field of the model, once baked; used until the next tick
+	if(anatomyFieldBaker != NULL)
+	{
+		SignedDistanceField* field = anatomyFieldBaker->acquire();
+		if(field != anatomyWalls)
 		{
-			if(startingPoint->getAsGhost())
-				setStartingPointStatus(true);
+			anatomyWalls = field;
+			updateAnatomyFreeSide();
 		}
+	}
 
-		values->tool->applyForces();
+	// the fixtures of the next module, handed over by the runner
+	FixtureSet* fixtureSet = runner->takePendingFixtureSet();
+	if(fixtureSet != NULL)
+		attachFixtureSet(fixtureSet);
+}
 
-		if(values->hasModuleEnded)close();
+//=========================================================//
 
-    }
-    
-    // exit haptics thread
-    simulationFinished = true;
+void attachFixtureSet(FixtureSet* fixtureSet)
+{
+	// called by the haptic thread. The lists are published in the same tick the scene node
+	// is queued; the haptic thread does not touch the world again until the node has been added
+	detachFixtureSet();
+
+	values->sceneCommands->addChild(values->world, fixtureSet->root);
+	values->sceneCommands->addChild(values->collisionWorld, fixtureSet->collisionRoot);
+	contactEvents.setSubscriptions(&fixtureSet->contactSubscriptions);
+	activeLines.clear();
+	fixtureSet->progress.reset();
+	values->pathProgress = &fixtureSet->progress;
+	values->guidanceField = (fixtureSet->config.G && !fixtureSet->guidanceField.isEmpty()) ?
+		&fixtureSet->guidanceField : NULL;
+	startingPoint		= fixtureSet->startingPoint;
+	updateFixtures		= fixtureSet->updateFixtures;
+	activeFixtureSet	= fixtureSet;
+	updateAnatomyFreeSide();
+
+	values->moduleName			= fixtureSet->config.name;
+	values->isTutorialModule	= fixtureSet->config.isTutorialModule;
+	values->isInsideThePath		= false;
+	values->numOfCollisions		= 0;
+	areFixturesAttached = true;
+
+	runner->notifyModuleStarted();
+}
+
+//=========================================================//
+
+void detachFixtureSet(void)
+{
+	// called by the haptic thread; the fixtures stop acting at once and are taken out of
+	// the scene by the graphics thread at its next frame
+	if(activeFixtureSet == NULL)
+		return;
+
+	values->sceneCommands->removeChild(values->world, activeFixtureSet->root);
+	values->sceneCommands->removeChild(values->collisionWorld, activeFixtureSet->collisionRoot);
+	contactEvents.setSubscriptions(NULL);
+	activeLines.clear();
+	values->pathProgress = NULL;
+	values->guidanceField = NULL;
+	activeFixtureSet	= NULL;
+	areFixturesAttached = false;
+}
+
+//=========================================================//
+
+void runModulesTask(void)
+{
+	for(int i=0; i<runner->getNumModules(); i++)
+	{
+		FixtureSet* fixtureSet = runner->getFixtureSet(i);
+
+		// usually built long before, while the previous module was running
+		fixtureSet->built.wait();
+		session->beginModule(fixtureSet);
+		runner->startModule(fixtureSet);
+		printInstructions();
+
+		// this thread is the session service while the module runs
+		session->runModule();
+
+		// the haptic thread has detached the set; once the graphics thread has taken it out
+		// of the scene, nothing refers to it any more
+		values->sceneCommands->waitForStructureChanges();
+		fixtureSet->release();
+	}
+
+	if(runner->getIsExperiment())
+		runner->collectTesterData();
+
+	close();
+	exit(0);
+}
+
+//=========================================================//
+
+void updateLoadingLabel(void)
+{
+	if(isLoadingFinished)
+		return;
+
+	bool isModelReady = (pointsMode != LOADED_MODEL) || atomicLoad(&isModelLoaded);
+	if(atomicLoad(&isDrillLoaded) && isModelReady && atomicLoad(&areFixturesBuilt))
+	{
+		loadingLabel->setShowEnabled(false);
+		isLoadingFinished = true;
+		return;
+	}
+
+	long done	= atomicLoad(&loadingStepsDone);
+	long total	= atomicLoad(&loadingStepsTotal);
+
+	long percent = (total > 0) ? (100 * done) / total : 0;
+	if(percent > 100)
+		percent = 100;
+
+	stringstream ss;
+	ss << "Loading... " << percent << "%";
+	loadingLabel->m_string = ss.str();
 }
 
 //=========================================================//
@@ -599,17 +1350,19 @@ void updateHaptics(void)
 void loadModel()
 {
 	string modelPath = "../resources/torusknot.obj";
+	modelFileName = modelPath;
 
 	bool fileload;
 	string resourceRoot;
 
 	model = new cMesh(values->world);
 
-	fileload = model->loadFromFile(RESOURCE_PATH(modelPath));
+	// large models are parsed and processed on all cores (see ParallelMeshLoader)
+	fileload = ParallelMeshLoader::loadFromFile(model, RESOURCE_PATH(modelPath));
 	if (!fileload)
 	{
 		#if defined(_MSVC)
-		fileload = model->loadFromFile(modelPath);
+		fileload = ParallelMeshLoader::loadFromFile(model, modelPath);
 		#endif
 	}
 	if (!fileload)
@@ -617,21 +1370,33 @@ void loadModel()
 		printf("Error - 3D Model failed to load correctly.\n");
 	}
 
-	cMaterial modelMaterial;
+    ParallelMeshLoader::computeAllNormals(model);
 
-    model->computeAllNormals(true);	
     model->computeBoundaryBox(true);
     double size = cSub(model->getBoundaryMax(), model->getBoundaryMin()).length();
     model->scale((2.0 * values->tool->getWorkspaceRadius() / size));
-	//model->createAABBCollisionDetector(values->proxyRadius, true, false);
-	//modelMaterial.setStiffness(0.4 * values->stiffnessMax);
-	//model->setMaterial(modelMaterial, true, true);
-	//model->setUseMaterial(true, true);
-	model->setAsGhost(true);
+	// the proxy collides with the triangles of the model through trees meant for large meshes
+	// (the AABB tree of CHAI3D is too slow for it at haptic rate); otherwise the walls of the
+	// model, if any, come from its distance field
+	if(values->areAnatomyWallsEnabled && values->isAnatomyMeshCollisionEnabled)
+	{
+		long long start		= getMonotonicNanoseconds();
+		int numNodes		= 0;
+		long memorySize		= 0;
+		MeshCollisionBVH::createCollisionDetectors(model, values->proxyRadius, numNodes, memorySize);
+		printf("Collision trees of the model: %d nodes (%.1f MB) in %.0f ms\n", numNodes,
+			memorySize / 1048576.0, 1000 * nanosecondsToSeconds(getMonotonicNanoseconds() - start));
+
+		setObjectStiffness(model, 0.4 * values->stiffnessMax);
+		model->setAsGhost(false);
+	}
+	else
+		model->setAsGhost(true);
 	model->setTransparencyLevel(1,true,true);
 	model->setUseCulling(true,true);
 	model->setTransparencyLevel(0.4);
-	values->world->addChild(model);
+
+	// the model is added to the world by attachLoadedAssets()
 }
 
 //=========================================================//
@@ -674,11 +1439,9 @@ void createPoints()
 			//=============================================
 
 			//CAUTION: The points are being stored in reverse order!
-			point = (Point*)malloc(sizeof(Point)); 
-
 			for(int i=0; i<POINTS_COUNT; i++)
 			{
-				point = new Point(pointsArray[i]);
+				point = pathArena->create<Point>(pointsArray[i]);
 				point->next=pointsHead;
 				pointsHead = point; 
 			}
@@ -693,12 +1456,11 @@ void createPoints()
 			break;
 		case READ_FROM_FILE:
 			int numOfMidpoints = 0;
-			point = (Point*)malloc(sizeof(Point)); 
 			string line;
 			double x;
 			double y;
 			double z;
-			ifstream myfile ("points_tutorial.txt");
+			ifstream myfile (values->pointsFileName.c_str());
 			if (myfile.is_open())
 			{
 				while ( getline (myfile,line) )
@@ -720,7 +1482,7 @@ void createPoints()
 						line.erase(0, pos + delimiter.length());
 					}
 					z = atof(line.c_str());
-					point = new Point(cVector3d(x,y,z));
+					point = pathArena->create<Point>(cVector3d(x,y,z));
 					point->next=pointsHead;
 					pointsHead = point; 
 					
@@ -754,8 +1516,6 @@ void extractMidpoints()
 	Point* pointsHead = NULL;
 	Point* point;
 
-	point = (Point*)malloc(sizeof(Point)); 
-
 	int vertNum = model->getNumVertices(true);
 	int space = 50;
 
@@ -785,10 +1545,10 @@ void extractMidpoints()
 		cVector3d avg = sum / space;
 
 		cShapeSphere* x = new cShapeSphere(0.005); 
-		values->world->addChild(x);
+		values->fixtureRoot->addChild(x);
 		x->setPos(avg);
 
-		point = new Point(avg);
+		point = pathArena->create<Point>(avg);
 		point->next=pointsHead;
 		pointsHead = point; 
 	}
@@ -802,20 +1562,20 @@ void extractMidpoints()
 
 void addStartingPointGuide()
 {
-	startingPoint = new cShapeSphere(0.03);
+	createdStartingPoint = new cShapeSphere(0.03);
 
-	values->world->addChild(startingPoint);
+	values->fixtureRoot->addChild(createdStartingPoint);
 
-	startingPoint->setPos(startingPointPos);
+	createdStartingPoint->setPos(startingPointPos);
 
 	values->magneticSphereMat.setStiffness(0.4 * values->stiffnessMax);
 	values->magneticSphereMat.setMagnetMaxForce(0.37 * values->forceMax * values->forceScaleFactor);
 	values->magneticSphereMat.setMagnetMaxDistance(values->stdBlockHeight * 3);
 
-	startingPoint->setMaterial(values->magneticSphereMat);
+	createdStartingPoint->setMaterial(values->magneticSphereMat);
 
-	cEffectMagnet* startingPointGuidingMagneticEffect = new cEffectMagnet(startingPoint);
-    startingPoint->addEffect(startingPointGuidingMagneticEffect);
+	cEffectMagnet* startingPointGuidingMagneticEffect = new cEffectMagnet(createdStartingPoint);
+    createdStartingPoint->addEffect(startingPointGuidingMagneticEffect);
 }
 
 //=========================================================//
@@ -855,11 +1615,10 @@ void createMagneticLinesFromPoints(Point* pointsHead)
 
 	MagneticLine* linesHead = NULL;
 	MagneticLine* line;
-	line = (MagneticLine*)malloc(sizeof(MagneticLine)); 
 	point = pointsHead;
 	for(int i=0; i<values->numOfMidPoints-1; i++)
 	{
-		line		= new MagneticLine(point->point, point->next->point);
+		line		= pathArena->create<MagneticLine>(point->point, point->next->point);
 		line->next	= linesHead;
 		linesHead	= line; 
 
@@ -892,15 +1651,15 @@ void printLines(MagneticLine* linesHead)
 
 //=========================================================//
 
-void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
+void createVFBlocksFromMagneticLines(MagneticLine* linesHead, FixtureWindow* window)
 {
 	MagneticLine*	line		= linesHead;
-	MagneticLine*	prevLine	= new MagneticLine(cVector3d(0,0,0), cVector3d(0,0,0));
+	MagneticLine*	prevLine	= pathArena->create<MagneticLine>(cVector3d(0,0,0), cVector3d(0,0,0));
 	VFBlock*		prevBlock	= NULL;
 	VFBlock*		blocksHead	= NULL;
-	VFBlock*		block		= (VFBlock*)malloc(sizeof(VFBlock));
+	VFBlock*		block		= NULL;
 	Corner*			cornersHead	= NULL;
-	Corner*			corner		= (Corner*)malloc(sizeof(Corner));
+	Corner*			corner		= NULL;
 	int				lineCount	= 0;
 	//MagneticLine*	nextLine;
 	cVector3d		v1;
@@ -914,20 +1673,31 @@ void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
 	cVector3d		P;
 	cVector3d		BNew;
 	double			translationDistance;
-	double			theta, compTheta, radius, theta1, theta2, theta3, theta4, n, x, sf2, sf2prev, rotStep;
+	double			theta, compTheta, radius, theta1, theta2, theta3, theta4, n, x, sf2, sf2prev;
 	double			directionAngle;
 		
 	while(line!=NULL)
 	{
 		lineCount++;
 
+		// the lines are listed from the end of the path; the block of a segment, the corner at
+		// its end and their lines go into the nodes of its group
+		FixtureGroup* group = window->getGroup((int)values->numOfMidPoints - 1 - lineCount);
+		if(group != NULL)
+		{
+			values->fixtureRoot				= group->root;
+			values->fixtureCollisionRoot	= group->collisionRoot;
+		}
+
 		// get the angle between the two lines
 		v2 = line->getVector();
 		vectorLength = v2.length();
 		theta = cRadToDeg(getAngleBetweenLines(prevLine, line));
 
 		//---------------- create and orient the cylinder along the direction vector
-		block = new VFBlock();
+		block = pathArena->create<VFBlock>();
+		if(group != NULL)
+			group->blocks.push_back(block);
 
 		v1 = block->getBottomCenterGlobalPos() - block->getTopCenterGlobalPos();
 		v1.normalize();
@@ -978,7 +1748,6 @@ void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
 		theta3		= 90 - theta2;								
 		theta4		= 180 - (2 * theta3);
 		x			= (n * sin(cDegToRad(theta3))) / (sin(cDegToRad(theta4)));
-		rotStep		= -1 * theta1/4;
 
 		//printf("\ntheta: %1.2f", theta);
 		//printf("\nradius: %1.2f", radius);
@@ -1011,133 +1780,16 @@ void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
 			block->setPos(BNew);	
 
 
-			//----------------------------------------create and orient the corner
-			cVector3d tran;
-			cVector3d cornerPos;
-			cVector3d newCornerPos;
-			double tranDistance = 0;
-			cMatrix3d rotMatrix;
-
-			rotMatrix = block->getRot();
-
-
-			corner = new Corner();
-			corner->rotate(rotMatrix);
-			//	this translation orients the corner unit at the end of the block unit
-			//------------- calculations start
-			B = corner->getPos();
-			P = line->getVector();
-			translationDistance = (block->getHeight());
-			BNew = B - (translationDistance/P.length()) * P;
-			//------------- calculations end
-			corner->setPos(BNew);		
-
-			//======= ROTATION 1: orienting the first corner (rotation across the line)
-			cVector3d N;
-			cVector3d L;
-
-			prevLine->getVector().crossr(line->getVector(), N);
-			//L = corner->getBottomSideGlobalPos() - corner->getBottomCenterGlobalPos();
-			L = corner->getTopSideGlobalPos() - corner->getTopCenterGlobalPos();
-			double alpha = cRadToDeg(acos((N.dot(L)/(N.length()*L.length()))));
-			cVector3d normalizedLineVector;
-			line->getVector().normalizer(normalizedLineVector);
-
-			// case 0
-			if(alpha >= -0.9 && alpha <=0.1)
-				corner->rotate(normalizedLineVector, alpha - 90);
-			// case 180
-			else if(alpha >= 179.9 && alpha <=180.1)
-				corner->rotate(normalizedLineVector, alpha + 90);
-			// other cases
-			else
-			{
-				cVector3d dirVector;
-				L.crossr(N, dirVector);
-				double dirAngle = acos((dirVector.dot(normalizedLineVector)/(dirVector.length()*normalizedLineVector.length())));
-				//printf("\nDIRECTION ANGLE = %1.5f, ALPHA = %1.5f\n", cRadToDeg(dirAngle), cRadToDeg(alpha));
-
-				// opposite direction
-				if((cRadToDeg(dirAngle) <= 180.1 && cRadToDeg(dirAngle) >= 179.9))
-					corner->rotate(normalizedLineVector, (-1 * alpha) - 90);
-				// same direction
-				else
-					corner->rotate(normalizedLineVector, alpha - 90);
-			}
-
-			//======= ROTATION 2: rotating the bottom of the corner across the cross product of the two lines
-			cVector3d rotAxis = cVector3d(0,0,0);
-			prevLine->getVector().crossr(line->getVector(), rotAxis);
-			rotAxis.normalize();
-			
-			//======= graphical representation of the cross product
-			//cShapeLine* lin = new cShapeLine(cVector3d(0,0,0), rotAxis);
-			//values->world->addChild(lin);
-			//lin->setPos(line->getB());
-
-			corner->rotateBottom(rotAxis,  -1 * theta1 - values->ROTATION_UNIT);
-
-
-			//this translation orients the corner unit at the center of the block unit
-			cornerPos = corner->getPos();
-			tran = block->getBottomCenterGlobalPos() - corner->getTopCenterGlobalPos();
-			tranDistance = tran.length();
-			newCornerPos = cornerPos + tran;
-			corner->setPos(newCornerPos);
-
-			//====== corner expansion among the corner space
-			Corner*	measure	= new Corner();
-			measure->setPos(corner->getPos());
-			measure->rotate(corner->getRot());
-
-			
-			cVector3d originalPos[6][20];
-			cVector3d pos[6][20];
-			cVector3d diff[6][20];
-			cMatrix3d rotm[6];
-			int vertNum = measure->getCylinderMesh()->getNumVertices(true);
-			int faceNum = 0;
-
-			for(int i=0; i<6; i++)
-				for(int j=0; j<21; j++)
-				{
-					if((i==0 && j<19) || (i==1 && j<21) || (i==2 && j<21) || (i==3 && j<21) || (i==4 && j<21)
-							|| (i==5 && j<20))
-					originalPos[i][j] = measure->getVertexPos(i, j);
-				}
-			
-			for(faceNum = 1; faceNum < 5; faceNum++)
-			{
-				if(faceNum == 1)
-					rotm[faceNum] = cRotMatrix(cVector3d(1,0,0), cDegToRad(rotStep - values->ROTATION_UNIT));
-				else
-					rotm[faceNum] = cRotMatrix(cVector3d(1,0,0), cDegToRad(rotStep));
-
-				for(int i=0; i<vertNum; i++)
-				{
-					measure->getCylinderMesh()->computeGlobalPositions();
-					measure->getCylinderMesh()->pVerticesNonEmpty()->at(i).setPos(
-						cMul(rotm[faceNum],measure->getCylinderMesh()->pVerticesNonEmpty()->at(i).getPos())
-						);
-				}
-
-
-				for(int i=0; i<20; i++)
-				{
-					pos[faceNum][i] = measure->getVertexPos(faceNum, i);
-					diff[faceNum][i] =  pos[faceNum][i] - originalPos[faceNum][i];
-					corner->translateVertex(faceNum, i, diff[faceNum][i]);
-				}
-			
-			}
-
-			corner->recalculateCollision();
-			measure->setAsGhost(true);
-			measure->setPos(0, 10, 10);
+			//----------------------------------------create and place the corner
+			// from the end of the block to the start of the next one, turning by the bend angle
+			corner = pathArena->create<Corner>(theta1, radius);
+			corner->place(block->getBottomCenterGlobalPos(), line->getVector(), prevLine->getVector());
+			if(group != NULL)
+				group->blocks.push_back(corner);
 
 			// create a magnetic line at the corner
 			MagneticLine* cornerLine = 
-				new MagneticLine(corner->getTopCenterGlobalPos(), corner->getBottomCenterGlobalPos());
+				pathArena->create<MagneticLine>(corner->getTopCenterGlobalPos(), corner->getBottomCenterGlobalPos());
 			cornerLine->setBlock(corner);
 
 			cornerLine->next = createdLines;
@@ -1160,6 +1812,8 @@ void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
 		prevLine = line;	
 		line = (MagneticLine* )line->next;
 
+		atomicIncrement(&loadingStepsDone);
+
 
 		
 	}
@@ -1186,5 +1840,65 @@ double getAngleBetweenLines(MagneticLine* prevLine, MagneticLine* line)
 
 //=========================================================//
 
+int countSceneNodes(cGenericObject* node, int& numCollisionMeshes)
+{
+	int numNodes = 0;
+	numCollisionMeshes = 0;
+
+	if(node == NULL)
+		return 0;
+
+	numNodes++;
+	if(node->getCollisionDetector() != NULL)
+		numCollisionMeshes++;
+
+	for(unsigned int i=0; i<node->getNumChildren(); i++)
+	{
+		int numChildMeshes;
+		numNodes += countSceneNodes(node->getChild(i), numChildMeshes);
+		numCollisionMeshes += numChildMeshes;
+	}
+
+	return numNodes;
+}
+
+//=========================================================//
+
+void setObjectStiffness(cGenericObject* node, double stiffness)
+{
+	node->m_material.setStiffness(stiffness);
+
+	for(unsigned int i=0; i<node->getNumChildren(); i++)
+		setObjectStiffness(node->getChild(i), stiffness);
+}
+
+//=========================================================//
+
+
+void printCollisionStatistics(void)
+{
+	// called by the graphics thread, which owns the scene graph
+	HapticSnapshot snapshot = snapshotBuffer.read();
+	int numSceneMeshes;
+	int numSceneNodes = countSceneNodes(values->world, numSceneMeshes);
+
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	printf("Proxy collision scene: %d nodes, %d with a collision tree\n",
+		snapshot.numCollisionNodes, snapshot.numCollisionMeshes);
+	printf("Whole scene: %d nodes, %d with a collision tree\n", numSceneNodes, numSceneMeshes);
+	printf("Proxy in the last tick: %d mesh queries, %d tree nodes visited, %d triangles tested\n",
+		snapshot.tickCollisionQueries, snapshot.tickVisitedNodes, snapshot.tickTestedTriangles);
+	if(snapshot.tick > 0)
+		printf("Proxy per tick on average: %.1f tree nodes visited, %.1f triangles tested\n",
+			(double)snapshot.numVisitedNodes / snapshot.tick, (double)snapshot.numTestedTriangles / snapshot.tick);
+	if(snapshot.numCollisionQueries > 0)
+		printf("Mesh queries answered from the last contact: %.1f%% of %ld\n",
+			100.0 * snapshot.numCollisionCacheHits / snapshot.numCollisionQueries, snapshot.numCollisionQueries);
+
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+}
+
+//=========================================================//
+
 
 
@@ -0,0 +1,868 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Mesh Collision BVH]
+A collision detector for large static meshes, used by the proxy in place of
+the AABB tree of CHAI3D: the anatomy model has up to millions of triangles
+and has to be checked on every haptic tick.
+The tree is built with the surface area heuristic, then collapsed so that
+every node has four children. A node is one cache line: the bounds of its
+four children, quantized to 16 bits on the bounds of the mesh, and their
+references. A segment is tested against the four boxes at once with SSE.
+The triangles of a leaf are contiguous in one array of indices.
+The proxy moves very little from one tick to the next, so each tree keeps
+the triangles near the last query: while the segment stays in a box around
+it, only those are tested and the tree is not walked at all.
+Meshes loaded from the same file and only scaled since (the blocks) share
+one prototype tree: the query is scaled into the frame of the prototype and
+the radius of the proxy grown per axis, so the culling stays exact. The
+exact tests still run on the triangles of each mesh.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+
+static const int	BVH_NUM_BINS		= 16;		// candidate splits per axis
+static const int	BVH_MAX_LEAF		= 8;		// triangles of a leaf; fits its 3 bits of count
+static const int	BVH_LEAF_BITS		= 3;
+static const int	BVH_MAX_DEPTH		= 48;		// deeper nodes are split at the median
+static const int	BVH_STACK_SIZE		= 256;		// 3 per level of the collapsed tree, and the root
+static const int	BVH_EMPTY			= 0x7FFFFFFF;	// a slot of a node without a child
+static const int	BVH_QUANTIZATION	= 65535;
+static const int	BVH_CACHE_LINE		= 64;
+static const double	BVH_TRAVERSAL_COST	= 1.0;		// of visiting a node, relative to testing a triangle
+static const double	BVH_CACHE_MARGIN	= 2.0;		// of the box of the cache, in proxy radii
+
+long MeshCollisionBVH::numQueries	= 0;
+long MeshCollisionBVH::numCacheHits	= 0;
+long MeshCollisionBVH::numVisitedNodes	= 0;
+long MeshCollisionBVH::numTestedTriangles	= 0;
+map<string, vector<MeshCollisionBVH*> > MeshCollisionBVH::prototypes;
+volatile long MeshCollisionBVH::prototypesLock = 0;
+
+// a node of the binary tree, before it is collapsed
+struct BVHBuildNode
+{
+	cVector3d	boundsMin;
+	cVector3d	boundsMax;
+	int			children[2];	// -1 for a leaf
+	int			first;			// the triangles of the node in indices
+	int			count;
+};
+
+// shared data of the build of one tree
+struct BVHBuildJob
+{
+	vector<cVector3d>		boxMin;			// per triangle of the mesh, grown by the radius
+	vector<cVector3d>		boxMax;
+	vector<cVector3d>		centroids;
+	vector<int>				indices;		// the allocated triangles, reordered leaf after leaf
+	vector<BVHBuildNode>	nodes;
+	vector<BVHNode>			collapsed;
+	cVector3d				origin;
+	cVector3d				step;
+};
+
+/*=========================================================//
+//==================[HELPER FUNCTIONS]=====================//
+//=========================================================*/
+
+static double getAxis(const cVector3d& v, int axis)
+{
+	return (axis == 0) ? v.x : ((axis == 1) ? v.y : v.z);
+}
+
+//=========================================================//
+
+static cVector3d mulElements(const cVector3d& a, const cVector3d& b)
+{
+	return cVector3d(a.x * b.x, a.y * b.y, a.z * b.z);
+}
+
+//=========================================================//
+
+// half axes of the box bounding a sphere of the radius, once scaled
+static cVector3d getGrowth(const cVector3d& scale, double radius)
+{
+	return cVector3d(fabs(scale.x) * radius, fabs(scale.y) * radius, fabs(scale.z) * radius);
+}
+
+//=========================================================//
+
+// the meshes of the object holding triangles, in the order the detectors are created
+static void collectMeshes(cGenericObject* object, vector<cMesh*>& meshes)
+{
+	cMesh* mesh = dynamic_cast<cMesh*>(object);
+	if(mesh != NULL && !mesh->pTriangles()->empty())
+		meshes.push_back(mesh);
+
+	for(unsigned int i=0; i<object->getNumChildren(); i++)
+		collectMeshes(object->getChild(i), meshes);
+}
+
+//=========================================================//
+
+static void growBounds(cVector3d& boundsMin, cVector3d& boundsMax, const cVector3d& low, const cVector3d& high)
+{
+	boundsMin.set(cMin(boundsMin.x, low.x), cMin(boundsMin.y, low.y), cMin(boundsMin.z, low.z));
+	boundsMax.set(cMax(boundsMax.x, high.x), cMax(boundsMax.y, high.y), cMax(boundsMax.z, high.z));
+}
+
+//=========================================================//
+
+// half the surface area of a box; the ratios are all the heuristic needs
+static double getHalfArea(const cVector3d& boundsMin, const cVector3d& boundsMax)
+{
+	cVector3d size = boundsMax - boundsMin;
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+//=========================================================//
+
+static int getBin(double centroid, double low, double extent)
+{
+	return cClamp((int)(BVH_NUM_BINS * (centroid - low) / extent), 0, BVH_NUM_BINS - 1);
+}
+
+//=========================================================//
+
+// orders the triangles of a node by their centroids along an axis
+struct CentroidLess
+{
+	const BVHBuildJob*	job;
+	int					axis;
+
+	bool operator()(int a, int b) const
+	{
+		return getAxis(job->centroids[a], axis) < getAxis(job->centroids[b], axis);
+	}
+};
+
+//=========================================================//
+
+// the triangles of a node whose centroid falls in the bins left of a split
+struct BinLess
+{
+	const BVHBuildJob*	job;
+	int					axis;
+	int					split;
+	double				low;
+	double				extent;
+
+	bool operator()(int index) const
+	{
+		return getBin(getAxis(job->centroids[index], axis), low, extent) < split;
+	}
+};
+
+//=========================================================//
+
+static int buildBinaryNode(BVHBuildJob& job, int first, int count, int depth)
+{
+	BVHBuildNode node;
+	node.boundsMin		= job.boxMin[job.indices[first]];
+	node.boundsMax		= job.boxMax[job.indices[first]];
+	node.children[0]	= -1;
+	node.children[1]	= -1;
+	node.first			= first;
+	node.count			= count;
+
+	cVector3d centroidMin = job.centroids[job.indices[first]];
+	cVector3d centroidMax = centroidMin;
+	for(int i=first; i<first+count; i++)
+	{
+		int triangle = job.indices[i];
+		growBounds(node.boundsMin, node.boundsMax, job.boxMin[triangle], job.boxMax[triangle]);
+		growBounds(centroidMin, centroidMax, job.centroids[triangle], job.centroids[triangle]);
+	}
+
+	int index = job.nodes.size();
+	job.nodes.push_back(node);
+	if(count == 1)
+		return index;
+
+	// the cheapest split between bins, against keeping the triangles in one leaf
+	double	area		= getHalfArea(node.boundsMin, node.boundsMax);
+	double	bestCost	= count * area;
+	int		bestAxis	= -1;
+	int		bestSplit	= 0;
+	for(int axis=0; axis<3 && depth<BVH_MAX_DEPTH; axis++)
+	{
+		double low		= getAxis(centroidMin, axis);
+		double extent	= getAxis(centroidMax, axis) - low;
+		if(extent <= 0)
+			continue;
+
+		int			binCount[BVH_NUM_BINS];
+		cVector3d	binMin[BVH_NUM_BINS];
+		cVector3d	binMax[BVH_NUM_BINS];
+		for(int b=0; b<BVH_NUM_BINS; b++)
+			binCount[b] = 0;
+
+		for(int i=first; i<first+count; i++)
+		{
+			int triangle	= job.indices[i];
+			int b			= getBin(getAxis(job.centroids[triangle], axis), low, extent);
+			if(binCount[b]++ == 0)
+			{
+				binMin[b] = job.boxMin[triangle];
+				binMax[b] = job.boxMax[triangle];
+			}
+			else
+				growBounds(binMin[b], binMax[b], job.boxMin[triangle], job.boxMax[triangle]);
+		}
+
+		// the right sides, swept from the last bin
+		double		rightArea[BVH_NUM_BINS];
+		int			rightCount[BVH_NUM_BINS];
+		cVector3d	sideMin, sideMax;
+		int			sideCount = 0;
+		for(int b=BVH_NUM_BINS-1; b>0; b--)
+		{
+			if(binCount[b] > 0)
+			{
+				if(sideCount == 0)
+				{
+					sideMin = binMin[b];
+					sideMax = binMax[b];
+				}
+				else
+					growBounds(sideMin, sideMax, binMin[b], binMax[b]);
+				sideCount += binCount[b];
+			}
+			rightCount[b]	= sideCount;
+			rightArea[b]	= (sideCount > 0) ? getHalfArea(sideMin, sideMax) : 0;
+		}
+
+		// the left sides, and the cost of each split
+		sideCount = 0;
+		for(int b=0; b<BVH_NUM_BINS-1; b++)
+		{
+			if(binCount[b] > 0)
+			{
+				if(sideCount == 0)
+				{
+					sideMin = binMin[b];
+					sideMax = binMax[b];
+				}
+				else
+					growBounds(sideMin, sideMax, binMin[b], binMax[b]);
+				sideCount += binCount[b];
+			}
+			if(sideCount == 0 || rightCount[b + 1] == 0)
+				continue;
+
+			double cost = BVH_TRAVERSAL_COST * area + sideCount * getHalfArea(sideMin, sideMax) +
+				rightCount[b + 1] * rightArea[b + 1];
+			if(cost < bestCost)
+			{
+				bestCost	= cost;
+				bestAxis	= axis;
+				bestSplit	= b + 1;
+			}
+		}
+	}
+
+	if(bestAxis < 0 && count <= BVH_MAX_LEAF)
+		return index;
+
+	int middle;
+	if(bestAxis >= 0)
+	{
+		BinLess isLeft;
+		isLeft.job		= &job;
+		isLeft.axis		= bestAxis;
+		isLeft.split	= bestSplit;
+		isLeft.low		= getAxis(centroidMin, bestAxis);
+		isLeft.extent	= getAxis(centroidMax, bestAxis) - isLeft.low;
+		middle = partition(job.indices.begin() + first, job.indices.begin() + first + count, isLeft) - job.indices.begin();
+	}
+	else
+	{
+		// too deep, or too many triangles on one point: halves along the longest axis
+		cVector3d extent = centroidMax - centroidMin;
+		CentroidLess isLess;
+		isLess.job	= &job;
+		isLess.axis	= (extent.x >= extent.y && extent.x >= extent.z) ? 0 : ((extent.y >= extent.z) ? 1 : 2);
+		middle = first + count / 2;
+		nth_element(job.indices.begin() + first, job.indices.begin() + middle, job.indices.begin() + first + count, isLess);
+	}
+
+	int left	= buildBinaryNode(job, first, middle - first, depth + 1);
+	int right	= buildBinaryNode(job, middle, first + count - middle, depth + 1);
+	job.nodes[index].children[0] = left;
+	job.nodes[index].children[1] = right;
+	return index;
+}
+
+//=========================================================//
+
+static unsigned short quantize(double value, double origin, double step, bool isUpper)
+{
+	// one step of margin, so that the boxes only ever grow
+	double q = (value - origin) / step;
+	q = isUpper ? ceil(q) + 1 : floor(q) - 1;
+	return (unsigned short)cClamp(q, 0.0, (double)BVH_QUANTIZATION);
+}
+
+//=========================================================//
+
+// collapses the binary node and its descendants into nodes of four children
+static int collapseNode(BVHBuildJob& job, int binaryIndex)
+{
+	int slots[4];
+	int numSlots = 0;
+	const BVHBuildNode& binary = job.nodes[binaryIndex];
+	if(binary.children[0] < 0)
+		slots[numSlots++] = binaryIndex;
+	else
+	{
+		slots[numSlots++] = binary.children[0];
+		slots[numSlots++] = binary.children[1];
+	}
+
+	// the largest inner slots are opened until the four are used
+	while(numSlots < 4)
+	{
+		int		largest		= -1;
+		double	largestArea	= -1;
+		for(int i=0; i<numSlots; i++)
+		{
+			const BVHBuildNode& slot = job.nodes[slots[i]];
+			double area = getHalfArea(slot.boundsMin, slot.boundsMax);
+			if(slot.children[0] >= 0 && area > largestArea)
+			{
+				largest		= i;
+				largestArea	= area;
+			}
+		}
+		if(largest < 0)
+			break;
+
+		int opened			= slots[largest];
+		slots[largest]		= job.nodes[opened].children[0];
+		slots[numSlots++]	= job.nodes[opened].children[1];
+	}
+
+	int index = job.collapsed.size();
+	job.collapsed.push_back(BVHNode());
+	for(int i=0; i<4; i++)
+	{
+		BVHNode& node = job.collapsed[index];
+		if(i >= numSlots)
+		{
+			node.minX[i] = node.minY[i] = node.minZ[i] = 0;
+			node.maxX[i] = node.maxY[i] = node.maxZ[i] = 0;
+			node.children[i] = BVH_EMPTY;
+			continue;
+		}
+
+		const BVHBuildNode& slot = job.nodes[slots[i]];
+		node.minX[i] = quantize(slot.boundsMin.x, job.origin.x, job.step.x, false);
+		node.minY[i] = quantize(slot.boundsMin.y, job.origin.y, job.step.y, false);
+		node.minZ[i] = quantize(slot.boundsMin.z, job.origin.z, job.step.z, false);
+		node.maxX[i] = quantize(slot.boundsMax.x, job.origin.x, job.step.x, true);
+		node.maxY[i] = quantize(slot.boundsMax.y, job.origin.y, job.step.y, true);
+		node.maxZ[i] = quantize(slot.boundsMax.z, job.origin.z, job.step.z, true);
+
+		if(slot.children[0] < 0)
+			node.children[i] = ~((slot.first << BVH_LEAF_BITS) | (slot.count - 1));
+		else
+		{
+			// the collapsed nodes may move while the child is built
+			int child = collapseNode(job, slots[i]);
+			job.collapsed[index].children[i] = child;
+		}
+	}
+
+	return index;
+}
+
+//=========================================================//
+
+static inline __m128 loadBounds(const unsigned short* bounds)
+{
+	__m128i words = _mm_loadl_epi64((const __m128i*)bounds);
+	return _mm_cvtepi32_ps(_mm_unpacklo_epi16(words, _mm_setzero_si128()));
+}
+
+//=========================================================//
+
+// bit i is set if the segment crosses the box of child i, grown by the radius; the parameter
+// along the segment of a lower bound q is q * scale + offsetLow, of an upper one q * scale + offsetHigh
+static inline int testChildren(const BVHNode& node, const __m128* scale, const __m128* offsetLow, const __m128* offsetHigh)
+{
+	__m128 t1		= _mm_add_ps(_mm_mul_ps(loadBounds(node.minX), scale[0]), offsetLow[0]);
+	__m128 t2		= _mm_add_ps(_mm_mul_ps(loadBounds(node.maxX), scale[0]), offsetHigh[0]);
+	__m128 tNear	= _mm_min_ps(t1, t2);
+	__m128 tFar		= _mm_max_ps(t1, t2);
+
+	t1		= _mm_add_ps(_mm_mul_ps(loadBounds(node.minY), scale[1]), offsetLow[1]);
+	t2		= _mm_add_ps(_mm_mul_ps(loadBounds(node.maxY), scale[1]), offsetHigh[1]);
+	tNear	= _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+	tFar	= _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+
+	t1		= _mm_add_ps(_mm_mul_ps(loadBounds(node.minZ), scale[2]), offsetLow[2]);
+	t2		= _mm_add_ps(_mm_mul_ps(loadBounds(node.maxZ), scale[2]), offsetHigh[2]);
+	tNear	= _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+	tFar	= _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+
+	tNear	= _mm_max_ps(tNear, _mm_setzero_ps());
+	tFar	= _mm_min_ps(tFar, _mm_set1_ps(1.0f));
+	return _mm_movemask_ps(_mm_cmple_ps(tNear, tFar));
+}
+
+//=========================================================//
+
+// bit i is set if the box of child i overlaps the given box, in steps of the grid
+static inline int testChildrenOverlap(const BVHNode& node, const __m128* low, const __m128* high)
+{
+	__m128 overlap = _mm_and_ps(_mm_cmple_ps(loadBounds(node.minX), high[0]), _mm_cmpge_ps(loadBounds(node.maxX), low[0]));
+	overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(loadBounds(node.minY), high[1]), _mm_cmpge_ps(loadBounds(node.maxY), low[1])));
+	overlap = _mm_and_ps(overlap, _mm_and_ps(_mm_cmple_ps(loadBounds(node.minZ), high[2]), _mm_cmpge_ps(loadBounds(node.maxZ), low[2])));
+	return _mm_movemask_ps(overlap);
+}
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+MeshCollisionBVH::MeshCollisionBVH(vector<cTriangle>* triangles, vector<cVertex>* vertices)
+{
+	this->triangles	= triangles;
+	this->vertices	= vertices;
+	tree			= this;
+	inverseScale.set(1, 1, 1);
+	nodes			= NULL;
+	numNodes		= 0;
+	radius			= 0;
+	isCacheValid	= false;
+	cacheMargin		= 0;
+	origin.zero();
+	step.set(1, 1, 1);
+	cacheMin.zero();
+	cacheMax.zero();
+}
+
+//=========================================================//
+
+MeshCollisionBVH::MeshCollisionBVH(vector<cTriangle>* triangles, vector<cVertex>* vertices, MeshCollisionBVH* prototype,
+								   const cVector3d& scale)
+{
+	this->triangles	= triangles;
+	this->vertices	= vertices;
+	tree			= prototype;
+	inverseScale.set(1.0 / scale.x, 1.0 / scale.y, 1.0 / scale.z);
+	nodes			= NULL;
+	numNodes		= 0;
+	radius			= 0;
+	isCacheValid	= false;
+	cacheMargin		= 0;
+	origin.zero();
+	step.set(1, 1, 1);
+	cacheMin.zero();
+	cacheMax.zero();
+}
+
+//=========================================================//
+
+MeshCollisionBVH::~MeshCollisionBVH(void)
+{
+	releaseNodes();
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::releaseNodes(void)
+{
+	if(nodes != NULL)
+	{
+#if defined(_WIN32)
+		_aligned_free(nodes);
+#else
+		free(nodes);
+#endif
+		nodes = NULL;
+	}
+	numNodes = 0;
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::initialize(double a_radius)
+{
+	cacheTriangles.clear();
+	isCacheValid	= false;
+	radius			= a_radius;
+
+	if(tree == this)
+		build();
+
+	// without a radius, the cache spans a hundredth of the mesh
+	cVector3d extent = mulElements(tree->step, cVector3d(BVH_QUANTIZATION / inverseScale.x,
+		BVH_QUANTIZATION / inverseScale.y, BVH_QUANTIZATION / inverseScale.z));
+	cacheMargin = (radius > 0) ? BVH_CACHE_MARGIN * radius : 0.01 * extent.length();
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::build(void)
+{
+	releaseNodes();
+	leafTriangles.clear();
+
+	// the boxes of the triangles; the radius of the proxy is added by the queries, per axis,
+	// so that the tree can be shared by meshes of other scales
+	BVHBuildJob job;
+	job.boxMin.resize(triangles->size());
+	job.boxMax.resize(triangles->size());
+	job.centroids.resize(triangles->size());
+	for(unsigned int t=0; t<triangles->size(); t++)
+	{
+		cTriangle& triangle = (*triangles)[t];
+		if(!triangle.m_allocated)
+			continue;
+
+		cVector3d a = mulElements((*vertices)[triangle.getIndexVertex0()].getPos(), inverseScale);
+		cVector3d b = mulElements((*vertices)[triangle.getIndexVertex1()].getPos(), inverseScale);
+		cVector3d c = mulElements((*vertices)[triangle.getIndexVertex2()].getPos(), inverseScale);
+		cVector3d low = a;
+		cVector3d high = a;
+		growBounds(low, high, b, b);
+		growBounds(low, high, c, c);
+
+		job.boxMin[t]		= low;
+		job.boxMax[t]		= high;
+		job.centroids[t]	= (low + high) * 0.5;
+		job.indices.push_back(t);
+	}
+	if(job.indices.empty())
+		return;
+
+	job.nodes.reserve(2 * job.indices.size());
+	buildBinaryNode(job, 0, job.indices.size(), 0);
+
+	// the quantization grid spans the root
+	const BVHBuildNode& root = job.nodes[0];
+	cVector3d extent = root.boundsMax - root.boundsMin;
+	origin = root.boundsMin;
+	step.set(extent.x > 0 ? extent.x / BVH_QUANTIZATION : 1,
+			 extent.y > 0 ? extent.y / BVH_QUANTIZATION : 1,
+			 extent.z > 0 ? extent.z / BVH_QUANTIZATION : 1);
+	job.origin	= origin;
+	job.step	= step;
+
+	job.collapsed.reserve(job.nodes.size() / 2 + 1);
+	collapseNode(job, 0);
+
+	size_t size = job.collapsed.size() * sizeof(BVHNode);
+#if defined(_WIN32)
+	nodes = (BVHNode*)_aligned_malloc(size, BVH_CACHE_LINE);
+#else
+	void* pool = NULL;
+	if(posix_memalign(&pool, BVH_CACHE_LINE, size) == 0)
+		nodes = (BVHNode*)pool;
+#endif
+	if(nodes == NULL)
+		return;
+
+	memcpy(nodes, &job.collapsed[0], size);
+	numNodes = job.collapsed.size();
+	leafTriangles.swap(job.indices);
+}
+
+//=========================================================//
+
+bool MeshCollisionBVH::computeCollision(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+										cCollisionRecorder& a_recorder, cCollisionSettings& a_settings)
+{
+	if(tree->nodes == NULL)
+		return false;
+
+	numQueries++;
+	cVector3d segmentMin = a_segmentPointA;
+	cVector3d segmentMax = a_segmentPointA;
+	growBounds(segmentMin, segmentMax, a_segmentPointB, a_segmentPointB);
+
+	bool isInsideCache = isCacheValid &&
+		segmentMin.x >= cacheMin.x && segmentMin.y >= cacheMin.y && segmentMin.z >= cacheMin.z &&
+		segmentMax.x <= cacheMax.x && segmentMax.y <= cacheMax.y && segmentMax.z <= cacheMax.z;
+
+	if(isInsideCache)
+		numCacheHits++;
+	else
+	{
+		// a long jump is checked from the root; a short motion refills the cache around it
+		cVector3d size = segmentMax - segmentMin;
+		if(cMax(size.x, cMax(size.y, size.z)) > cacheMargin)
+		{
+			isCacheValid = false;
+			return traverse(a_segmentPointA, a_segmentPointB, a_recorder, a_settings);
+		}
+
+		cVector3d margin(cacheMargin, cacheMargin, cacheMargin);
+		fillCache(segmentMin - margin, segmentMax + margin);
+	}
+
+	// the segment is inside the box of the cache, so no other triangle can touch it
+	numTestedTriangles += cacheTriangles.size();
+	bool isHit = false;
+	for(unsigned int i=0; i<cacheTriangles.size(); i++)
+		if((*triangles)[cacheTriangles[i]].computeCollision(a_segmentPointA, a_segmentPointB, a_recorder, a_settings))
+			isHit = true;
+
+	return isHit;
+}
+
+//=========================================================//
+
+bool MeshCollisionBVH::traverse(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+								cCollisionRecorder& a_recorder, cCollisionSettings& a_settings)
+{
+	// the segment in the frame of the tree, where the sphere of the proxy becomes an ellipsoid;
+	// the boxes are grown by its half axes. In steps of the grid, a lower bound q along an axis
+	// is crossed at q * scale + offsetLow
+	cVector3d pointA	= mulElements(a_segmentPointA, inverseScale);
+	cVector3d direction	= mulElements(a_segmentPointB, inverseScale) - pointA;
+	cVector3d grow		= getGrowth(inverseScale, radius);
+	__m128 scale[3];
+	__m128 offsetLow[3];
+	__m128 offsetHigh[3];
+	for(int axis=0; axis<3; axis++)
+	{
+		double d		= getAxis(direction, axis);
+		double inverse	= (fabs(d) > 1e-20) ? 1.0 / d : ((d < 0) ? -1e30 : 1e30);
+		double start	= getAxis(tree->origin, axis) - getAxis(pointA, axis);
+		scale[axis]		= _mm_set1_ps((float)(getAxis(tree->step, axis) * inverse));
+		offsetLow[axis]	= _mm_set1_ps((float)((start - getAxis(grow, axis)) * inverse));
+		offsetHigh[axis]= _mm_set1_ps((float)((start + getAxis(grow, axis)) * inverse));
+	}
+
+	const BVHNode*		treeNodes			= tree->nodes;
+	const vector<int>&	treeLeafTriangles	= tree->leafTriangles;
+	bool	isHit = false;
+	int		stack[BVH_STACK_SIZE];
+	int		stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const BVHNode& node = treeNodes[stack[--stackSize]];
+		int crossed = testChildren(node, scale, offsetLow, offsetHigh);
+		numVisitedNodes++;
+
+		for(int i=0; i<4; i++)
+		{
+			int child = node.children[i];
+			if(!(crossed & (1 << i)) || child == BVH_EMPTY)
+				continue;
+
+			if(child >= 0)
+			{
+				stack[stackSize++] = child;
+				continue;
+			}
+
+			// a leaf; the triangle records the collision as it would under cCollisionAABB
+			int first	= (~child) >> BVH_LEAF_BITS;
+			int count	= ((~child) & ((1 << BVH_LEAF_BITS) - 1)) + 1;
+			numTestedTriangles += count;
+			for(int j=first; j<first+count; j++)
+				if((*triangles)[treeLeafTriangles[j]].computeCollision(a_segmentPointA, a_segmentPointB, a_recorder, a_settings))
+					isHit = true;
+		}
+	}
+
+	return isHit;
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::fillCache(const cVector3d& boxMin, const cVector3d& boxMax)
+{
+	cacheMin		= boxMin;
+	cacheMax		= boxMax;
+	isCacheValid	= true;
+	cacheTriangles.clear();
+
+	// the box in the frame of the tree, grown by the half axes of the proxy there, in steps of the grid
+	cVector3d low	= mulElements(boxMin, inverseScale) - getGrowth(inverseScale, radius);
+	cVector3d high	= mulElements(boxMax, inverseScale) + getGrowth(inverseScale, radius);
+	__m128 gridLow[3];
+	__m128 gridHigh[3];
+	for(int axis=0; axis<3; axis++)
+	{
+		gridLow[axis]	= _mm_set1_ps((float)((getAxis(low, axis) - getAxis(tree->origin, axis)) / getAxis(tree->step, axis)));
+		gridHigh[axis]	= _mm_set1_ps((float)((getAxis(high, axis) - getAxis(tree->origin, axis)) / getAxis(tree->step, axis)));
+	}
+
+	const BVHNode*		treeNodes			= tree->nodes;
+	const vector<int>&	treeLeafTriangles	= tree->leafTriangles;
+	int stack[BVH_STACK_SIZE];
+	int stackSize = 0;
+	stack[stackSize++] = 0;
+	while(stackSize > 0)
+	{
+		const BVHNode& node = treeNodes[stack[--stackSize]];
+		int overlapping = testChildrenOverlap(node, gridLow, gridHigh);
+		numVisitedNodes++;
+
+		for(int i=0; i<4; i++)
+		{
+			int child = node.children[i];
+			if(!(overlapping & (1 << i)) || child == BVH_EMPTY)
+				continue;
+
+			if(child >= 0)
+			{
+				stack[stackSize++] = child;
+				continue;
+			}
+
+			int first	= (~child) >> BVH_LEAF_BITS;
+			int count	= ((~child) & ((1 << BVH_LEAF_BITS) - 1)) + 1;
+			for(int j=first; j<first+count; j++)
+				cacheTriangles.push_back(treeLeafTriangles[j]);
+		}
+	}
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::createCollisionDetectors(cGenericObject* object, double radius, int& numNodes, long& memorySize)
+{
+	cMesh* mesh = dynamic_cast<cMesh*>(object);
+	if(mesh != NULL && !mesh->pTriangles()->empty())
+	{
+		mesh->deleteCollisionDetector(false);
+		MeshCollisionBVH* tree = new MeshCollisionBVH(mesh->pTriangles(), mesh->pVertices());
+		tree->initialize(radius);
+		mesh->setCollisionDetector(tree);
+
+		numNodes	+= tree->getNumNodes();
+		memorySize	+= tree->getMemorySize();
+	}
+
+	for(unsigned int i=0; i<object->getNumChildren(); i++)
+		createCollisionDetectors(object->getChild(i), radius, numNodes, memorySize);
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::createCollisionDetectors(cGenericObject* object, double radius)
+{
+	int		numNodes	= 0;
+	long	memorySize	= 0;
+	createCollisionDetectors(object, radius, numNodes, memorySize);
+}
+
+//=========================================================//
+
+void MeshCollisionBVH::createSharedCollisionDetectors(cGenericObject* object, string prototypeName,
+													  const cVector3d& scale, double radius)
+{
+	vector<cMesh*> meshes;
+	collectMeshes(object, meshes);
+
+	// the first copy of the meshes becomes the prototype, brought back to the scale it was loaded at;
+	// it only reads the vertices while it is built
+	while(atomicExchange(&prototypesLock, 1) != 0)
+		cSleepMs(1);
+
+	vector<MeshCollisionBVH*>& shared = prototypes[prototypeName];
+	if(shared.empty())
+	{
+		for(unsigned int i=0; i<meshes.size(); i++)
+		{
+			MeshCollisionBVH* prototype = new MeshCollisionBVH(meshes[i]->pTriangles(), meshes[i]->pVertices());
+			prototype->inverseScale.set(1.0 / scale.x, 1.0 / scale.y, 1.0 / scale.z);
+			prototype->build();
+			prototype->triangles	= NULL;
+			prototype->vertices		= NULL;
+			shared.push_back(prototype);
+		}
+	}
+	atomicStore(&prototypesLock, 0);
+
+	// not the same meshes after all
+	if(shared.size() != meshes.size())
+	{
+		createCollisionDetectors(object, radius);
+		return;
+	}
+
+	for(unsigned int i=0; i<meshes.size(); i++)
+	{
+		meshes[i]->deleteCollisionDetector(false);
+		MeshCollisionBVH* instance = new MeshCollisionBVH(meshes[i]->pTriangles(), meshes[i]->pVertices(), shared[i], scale);
+		instance->initialize(radius);
+		meshes[i]->setCollisionDetector(instance);
+	}
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+int MeshCollisionBVH::getNumNodes(void)
+{
+	return numNodes;
+}
+
+//=========================================================//
+
+int MeshCollisionBVH::getNumTriangles(void)
+{
+	return (int)leafTriangles.size();
+}
+
+//=========================================================//
+
+long MeshCollisionBVH::getMemorySize(void)
+{
+	return (long)numNodes * sizeof(BVHNode) + (long)(leafTriangles.size() * sizeof(int));
+}
+
+//=========================================================//
+
+long MeshCollisionBVH::getNumQueries(void)
+{
+	return numQueries;
+}
+
+//=========================================================//
+
+long MeshCollisionBVH::getNumCacheHits(void)
+{
+	return numCacheHits;
+}
+
+//=========================================================//
+
+long MeshCollisionBVH::getNumVisitedNodes(void)
+{
+	return numVisitedNodes;
+}
+
+//=========================================================//
+
+long MeshCollisionBVH::getNumTestedTriangles(void)
+{
+	return numTestedTriangles;
+}
+
+//=========================================================//
@@ -0,0 +1,136 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Mesh Collision BVH]
+A collision detector for large static meshes, used by the proxy in place of
+the AABB tree of CHAI3D: the anatomy model has up to millions of triangles
+and has to be checked on every haptic tick.
+The tree is built with the surface area heuristic, then collapsed so that
+every node has four children. A node is one cache line: the bounds of its
+four children, quantized to 16 bits on the bounds of the mesh, and their
+references. A segment is tested against the four boxes at once with SSE.
+The triangles of a leaf are contiguous in one array of indices.
+The proxy moves very little from one tick to the next, so each tree keeps
+the triangles near the last query: while the segment stays in a box around
+it, only those are tested and the tree is not walked at all.
+Meshes loaded from the same file and only scaled since (the blocks) share
+one prototype tree: the query is scaled into the frame of the prototype and
+the radius of the proxy grown per axis, so the culling stays exact. The
+exact tests still run on the triangles of each mesh.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+// four children of a node, 64 bytes; the bounds are in steps of the quantization grid
+typedef struct BVHNode{
+
+public:
+	unsigned short	minX[4];
+	unsigned short	minY[4];
+	unsigned short	minZ[4];
+	unsigned short	maxX[4];
+	unsigned short	maxY[4];
+	unsigned short	maxZ[4];
+	int				children[4];	// a node, a leaf (negative) or none
+
+};
+
+class MeshCollisionBVH : public cGenericCollision
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<cTriangle>*	triangles;			// of the mesh
+	vector<cVertex>*	vertices;
+	MeshCollisionBVH*	tree;				// the one holding the nodes: this one, or a shared prototype
+	cVector3d			inverseScale;		// from the frame of the mesh to the frame of the tree
+	BVHNode*			nodes;				// the root first, aligned on cache lines
+	int					numNodes;
+	vector<int>			leafTriangles;		// indices of the triangles, leaf after leaf
+	cVector3d			origin;				// the quantization grid, over the bounds of the mesh
+	cVector3d			step;
+	double				radius;				// of the proxy; the queries are grown by it
+
+	// temporal coherence, haptic thread only: the triangles whose boxes overlap a box around
+	// the last query, the only ones a segment inside it can touch
+	bool				isCacheValid;
+	cVector3d			cacheMin;
+	cVector3d			cacheMax;
+	vector<int>			cacheTriangles;
+	double				cacheMargin;		// the box of the segment is grown by it when the cache is refilled
+
+	static long			numQueries;			// of all the trees, haptic thread only
+	static long			numCacheHits;
+	static long			numVisitedNodes;	// popped by the walks of the trees
+	static long			numTestedTriangles;	// checked against the segments
+	static map<string, vector<MeshCollisionBVH*> >	prototypes;	// per mesh file, one per child mesh; kept for good
+	static volatile long	prototypesLock;		// the build thread and the workers may look them up together
+
+	//========================[METHODS]========================//
+	// not copyable, the nodes are owned
+	MeshCollisionBVH(const MeshCollisionBVH&);
+	MeshCollisionBVH& operator=(const MeshCollisionBVH&);
+
+	// a mesh sharing the tree of the prototype; its vertices are those of the prototype times the scale
+	MeshCollisionBVH(vector<cTriangle>* triangles, vector<cVertex>* vertices, MeshCollisionBVH* prototype,
+					 const cVector3d& scale);
+
+	void		releaseNodes(void);
+	// builds the tree over the vertices of the mesh times inverseScale
+	void		build(void);
+	// tests the segment against the tree, from the root
+	bool		traverse(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+						 cCollisionRecorder& a_recorder, cCollisionSettings& a_settings);
+	// fills the cache with the triangles whose boxes overlap the given box
+	void		fillCache(const cVector3d& boxMin, const cVector3d& boxMax);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the tree is built by initialize()
+	MeshCollisionBVH(vector<cTriangle>* triangles, vector<cVertex>* vertices);
+	// destructor
+	virtual ~MeshCollisionBVH(void);
+	// builds the tree, unless it is shared, for a proxy of the given radius; the mesh is not
+	// to change afterwards
+	virtual void	initialize(double a_radius = 0);
+	// checks the segment against the triangles of the mesh, as cCollisionAABB does
+	virtual bool	computeCollision(cVector3d& a_segmentPointA, cVector3d& a_segmentPointB,
+									 cCollisionRecorder& a_recorder, cCollisionSettings& a_settings);
+
+	// replaces the collision detectors of the object and of its child meshes by trees;
+	// adds the nodes and bytes of the trees to the counters
+	static void		createCollisionDetectors(cGenericObject* object, double radius, int& numNodes, long& memorySize);
+	static void		createCollisionDetectors(cGenericObject* object, double radius);
+	// as createCollisionDetectors, for an object loaded from the named file and scaled since by
+	// the given factors; the trees are built once per file and shared
+	static void		createSharedCollisionDetectors(cGenericObject* object, string prototypeName,
+												   const cVector3d& scale, double radius);
+
+
+	//========================[METHODS]===setters & getters====//
+	int			getNumNodes(void);
+	int			getNumTriangles(void);
+	// bytes used by the nodes and the triangle indices
+	long		getMemorySize(void);
+	// queries of all the trees so far, and how many were answered from their caches
+	static long	getNumQueries(void);
+	static long	getNumCacheHits(void);
+	// nodes the queries have visited and triangles they have tested so far
+	static long	getNumVisitedNodes(void);
+	static long	getNumTestedTriangles(void);
+
+};
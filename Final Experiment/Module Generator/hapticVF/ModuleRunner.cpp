@@ -0,0 +1,292 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Module Runner]
+Runs one or more experiment modules (V, FV, GV, FG, COM and the tutorial) in a
+single process. The world, the haptic device and the loaded meshes stay alive
+for the whole session; every module gets its own fixture set, built in the
+background, and switching modules only swaps the active set in the haptic loop.
+This is a singleton class.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+bool			ModuleRunner::instanceFlag		= false;
+ModuleRunner*	ModuleRunner::single			= NULL;
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+FixtureSet::FixtureSet(const ModuleConfig& config)
+{
+	this->config	= config;
+	root			= NULL;
+	collisionRoot	= NULL;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+	lines			= NULL;
+	vfBlocks		= NULL;
+	corners			= NULL;
+	startingPoint	= NULL;
+	numOfMidPoints	= 0;
+	updateFixtures	= getFixturePipeline(config.V, config.G);
+}
+
+//=========================================================//
+
+void FixtureSet::release(void)
+{
+	// the groups hang from the roots, which the arena deletes last
+	window.release();
+	guidanceField.release();
+	arena.release();
+
+	ContactSubscriptionMap().swap(contactSubscriptions);
+	root			= NULL;
+	collisionRoot	= NULL;
+	numCollisionNodes	= 0;
+	numCollisionMeshes	= 0;
+	lines			= NULL;
+	vfBlocks		= NULL;
+	corners			= NULL;
+	startingPoint	= NULL;
+}
+
+//=========================================================//
+
+ModuleRunner::ModuleRunner(void)
+{
+	pendingFixtureSet	= NULL;
+	currentModule		= -1;
+	isExperiment		= false;
+}
+
+//=========================================================//
+
+ModuleRunner* ModuleRunner::getInstance(void)
+{
+	if(!instanceFlag)
+	{
+		single = new ModuleRunner();
+		instanceFlag = true;
+		return single;
+	}
+	else
+	{
+		return single;
+	}
+}
+
+//=========================================================//
+
+bool ModuleRunner::getModuleConfig(string name, ModuleConfig& config)
+{
+	config.name				= name;
+	config.V				= true;
+	config.F				= true;
+	config.G				= true;
+	config.isTutorialModule	= false;
+	config.pointsFileName	= "points.txt";
+
+	if(name == "V")
+	{
+		config.F = false;
+		config.G = false;
+	}
+	else if(name == "FV")
+		config.G = false;
+	else if(name == "GV")
+		config.F = false;
+	else if(name == "FG")
+		config.V = false;
+	else if(name == "TUTORIAL")
+	{
+		config.isTutorialModule	= true;
+		config.pointsFileName	= "points_tutorial.txt";
+	}
+	else if(name != "COM")
+		return false;
+
+	return true;
+}
+
+//=========================================================//
+
+void ModuleRunner::addModule(const ModuleConfig& config)
+{
+	fixtureSets.push_back(new FixtureSet(config));
+}
+
+//=========================================================//
+
+void ModuleRunner::planExperiment(void)
+{
+	const int	NUM_TESTING_MODULES = 5;
+	string		testingModules[NUM_TESTING_MODULES] = {"V", "FV", "GV", "FG", "COM"};
+	ModuleConfig config;
+
+	isExperiment = true;
+
+	printf("+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+	printf("Robotic Surgery Haptic Simulation Experiment\n");
+	printf("+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++\n");
+
+	char userResponse;
+	cout<<"Would you like to run the tutorial module? [y/n]"<<endl;
+	cin>>userResponse;
+	cout<<endl;
+
+	if(userResponse=='y')
+	{
+		getModuleConfig("TUTORIAL", config);
+		addModule(config);
+	}
+
+	// the testing modules run in a random order
+	srand((unsigned int)time(NULL));
+	for(int i=NUM_TESTING_MODULES-1; i>0; i--)
+	{
+		int j = rand() % (i + 1);
+		string temp = testingModules[i];
+		testingModules[i] = testingModules[j];
+		testingModules[j] = temp;
+	}
+
+	for(int i=0; i<NUM_TESTING_MODULES; i++)
+	{
+		getModuleConfig(testingModules[i], config);
+		addModule(config);
+	}
+}
+
+//=========================================================//
+
+void ModuleRunner::collectTesterData(void)
+{
+	clearScreen();
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	cout<<"Tester's Data"<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+
+	char gender;
+	int age;
+	char prevExperienceWithHaptics;
+
+	cout<<"Do you have a previous experience with haptics? [y/n]: ";
+	cin>>prevExperienceWithHaptics;
+	cout<<"Your age: ";
+	cin>>age;
+	cout<<"Your gender [m/f]: ";
+	cin>>gender;
+
+	ofstream myfile;
+	myfile.open ("OUTPUT_TESTER_DATA.txt");
+	myfile << prevExperienceWithHaptics <<endl;
+	myfile << age <<endl;
+	myfile << gender <<endl;
+	myfile.close();
+
+	cout<<endl<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	cout<<"Thank you for your valued contribution. Have a nice day!"<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+}
+
+//=========================================================//
+
+void ModuleRunner::clearScreen(void)
+{
+#if defined(_WIN32)
+	system("cls");
+#else
+	system("clear");
+#endif
+}
+
+//=========================================================//
+
+void ModuleRunner::startModule(FixtureSet* fixtureSet)
+{
+	currentModule = 0;
+	while(fixtureSets[currentModule] != fixtureSet)
+		currentModule++;
+
+	if(isExperiment)
+	{
+		clearScreen();
+		printf("======================\n");
+		printf("Module # %d\n", currentModule + 1);
+		printf("======================\n");
+	}
+
+	moduleStarted.reset();
+	atomicExchangePointer(&pendingFixtureSet, fixtureSet);
+
+	moduleStarted.wait();
+}
+
+//=========================================================//
+
+FixtureSet* ModuleRunner::takePendingFixtureSet(void)
+{
+	// cheap check first; this is called on every haptic tick
+	if(atomicLoadPointer(&pendingFixtureSet) == NULL)
+		return NULL;
+
+	return (FixtureSet*)atomicExchangePointer(&pendingFixtureSet, NULL);
+}
+
+//=========================================================//
+
+void ModuleRunner::notifyModuleStarted(void)
+{
+	moduleStarted.set();
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+bool ModuleRunner::getIsExperiment(void)
+{
+	return isExperiment;
+}
+
+//=========================================================//
+
+bool ModuleRunner::isLastModule(void)
+{
+	return currentModule >= (int)fixtureSets.size() - 1;
+}
+
+//=========================================================//
+
+int ModuleRunner::getNumModules(void)
+{
+	return (int)fixtureSets.size();
+}
+
+//=========================================================//
+
+FixtureSet* ModuleRunner::getFixtureSet(int index)
+{
+	return fixtureSets[index];
+}
+
+//=========================================================//
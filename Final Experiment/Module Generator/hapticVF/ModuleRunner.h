@@ -0,0 +1,119 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Module Runner]
+Runs one or more experiment modules (V, FV, GV, FG, COM and the tutorial) in a
+single process. The world, the haptic device and the loaded meshes stay alive
+for the whole session; every module gets its own fixture set, built in the
+background, and switching modules only swaps the active set in the haptic loop.
+This is a singleton class.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+typedef struct ModuleConfig{
+
+public:
+	string		name;
+	bool		V;					// visual feedback
+	bool		F;					// forbidden-region fixtures
+	bool		G;					// guidance fixtures
+	bool		isTutorialModule;
+	string		pointsFileName;
+
+};
+
+typedef struct FixtureSet{
+
+public:
+	//========================[VARIABLES]======================//
+	ModuleConfig	config;
+	PathArena		arena;			// owns everything built for the set, its roots included
+	cGenericObject*	root;			// parent of every fixture of the set
+	cGenericObject*	collisionRoot;	// parent of the meshes of the set the proxy collides with
+	int				numCollisionNodes;	// nodes under collisionRoot, the candidates of each proxy query
+	int				numCollisionMeshes;	// of which have a collision tree
+	MagneticLine*	lines;
+	VFBlock*		vfBlocks;
+	Corner*			corners;
+	cShapeSphere*	startingPoint;
+	FixturePipelineFunction	updateFixtures;	// specialized for the module's feedback
+	ContactSubscriptionMap	contactSubscriptions;	// the meshes of the set, for the contact events
+	PathProgress	progress;		// over the waypoints of the set
+	GuidanceVectorField	guidanceField;	// baked when the guidance is read from a field
+	FixtureWindow	window;			// the fixtures of each segment, and which of them are in the scene
+
+
+	double			numOfMidPoints;
+	ThreadEvent		built;			// signaled once the set is complete
+
+	//========================[METHODS]========================//
+	FixtureSet(const ModuleConfig& config);
+	// deletes everything built for the set, which is to be out of the scene; the
+	// config and the number of waypoints are kept for the session
+	void		release(void);
+
+};
+
+class ModuleRunner
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	static bool				instanceFlag;
+	static ModuleRunner*	single;
+
+	vector<FixtureSet*>		fixtureSets;			// in running order
+	int						currentModule;
+	void* volatile			pendingFixtureSet;		// handed from the runner to the haptic thread
+	ThreadEvent				moduleStarted;
+	bool					isExperiment;
+
+	//========================[METHODS]========================//
+	// constructor
+	ModuleRunner(void);
+	// clears the console between modules
+	void		clearScreen(void);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// returns the unique instance of ModuleRunner
+	static ModuleRunner*	getInstance(void);
+	// looks up the configuration of a module by name (V, FV, GV, FG, COM, TUTORIAL)
+	static bool				getModuleConfig(string name, ModuleConfig& config);
+
+	// adds a single module to run
+	void		addModule(const ModuleConfig& config);
+	// asks for the tutorial and adds the five testing modules in random order
+	void		planExperiment(void);
+	// asks for the tester's data and writes it to file; call after the last module
+	void		collectTesterData(void);
+	bool		getIsExperiment(void);
+	// true while the last module of the session is running
+	bool		isLastModule(void);
+	int			getNumModules(void);
+	FixtureSet*	getFixtureSet(int index);
+
+	//========================[METHODS]=========runner thread==//
+	// hands the set to the haptic thread and blocks until it has been swapped in
+	void		startModule(FixtureSet* fixtureSet);
+
+	//========================[METHODS]=========haptic thread==//
+	// returns the set to swap in, or NULL if there is none
+	FixtureSet*	takePendingFixtureSet(void);
+	void		notifyModuleStarted(void);
+};
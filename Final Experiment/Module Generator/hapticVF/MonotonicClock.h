@@ -0,0 +1,45 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Monotonic Clock]
+A nanosecond timestamp from the monotonic high-resolution clock of the system.
+Cheap enough to read from the haptic loop when an event happens; only the
+differences between two timestamps are meaningful.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+// returns the current time in nanoseconds
+inline long long getMonotonicNanoseconds(void)
+{
+#if defined(_WIN32)
+	LARGE_INTEGER frequency;
+	LARGE_INTEGER counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+
+	// split in whole seconds and remainder so the product does not overflow
+	long long seconds	= counter.QuadPart / frequency.QuadPart;
+	long long remainder	= counter.QuadPart % frequency.QuadPart;
+	return seconds * 1000000000LL + (remainder * 1000000000LL) / frequency.QuadPart;
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+#endif
+}
+
+// converts a difference of timestamps to seconds
+inline double nanosecondsToSeconds(long long nanoseconds)
+{
+	return nanoseconds * 1e-9;
+}
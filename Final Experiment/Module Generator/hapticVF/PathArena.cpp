@@ -0,0 +1,151 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Path Arena]
+Owns everything built for one path: its points, lines, blocks and corners
+are placed one after the other in large blocks of memory, and the scene
+nodes that hang from no fixture, such as the roots of the set, are
+adopted. Nothing of a path is freed on its own; release() destroys the objects in the reverse order of
+their creation, deletes the adopted nodes with their children and gives the
+memory back at once, after which the arena can hold another path.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+static const size_t	ARENA_BLOCK_SIZE	= 64 * 1024;
+static const size_t	ARENA_ALIGNMENT		= 16;
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+PathArena::PathArena(void)
+{
+	cursor		= NULL;
+	remaining	= 0;
+	numBytes	= 0;
+}
+
+//=========================================================//
+
+PathArena::~PathArena(void)
+{
+	release();
+}
+
+//=========================================================//
+
+void* PathArena::allocate(size_t size)
+{
+	size = (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+
+	if(size > remaining)
+	{
+		// an object larger than a block gets one of its own; the last block stays the current one
+		size_t blockSize = (size > ARENA_BLOCK_SIZE) ? size : ARENA_BLOCK_SIZE;
+		char* block = NULL;
+#if defined(_WIN32)
+		block = (char*)_aligned_malloc(blockSize, ARENA_ALIGNMENT);
+#else
+		void* memory = NULL;
+		if(posix_memalign(&memory, ARENA_ALIGNMENT, blockSize) == 0)
+			block = (char*)memory;
+#endif
+		if(block == NULL)
+			throw bad_alloc();
+
+		numBytes += (long)blockSize;
+		if(blockSize > ARENA_BLOCK_SIZE)
+		{
+			blocks.insert(blocks.begin(), block);
+			return block;
+		}
+
+		blocks.push_back(block);
+		cursor		= block;
+		remaining	= blockSize;
+	}
+
+	void* memory = cursor;
+	cursor		+= size;
+	remaining	-= size;
+	return memory;
+}
+
+//=========================================================//
+
+void PathArena::track(void* object, Destructor destructor)
+{
+	Allocation allocation;
+	allocation.object		= object;
+	allocation.destructor	= destructor;
+	allocations.push_back(allocation);
+}
+
+//=========================================================//
+
+cGenericObject* PathArena::adopt(cGenericObject* node)
+{
+	if(node != NULL)
+		nodes.push_back(node);
+
+	return node;
+}
+
+//=========================================================//
+
+void PathArena::release(void)
+{
+	// the objects first: they may still point into the nodes, never the other way round
+	for(int i=(int)allocations.size() - 1; i>=0; i--)
+		allocations[i].destructor(allocations[i].object);
+
+	for(int i=(int)nodes.size() - 1; i>=0; i--)
+	{
+		if(nodes[i]->getParent() != NULL)
+			nodes[i]->getParent()->removeChild(nodes[i]);
+		delete nodes[i];
+	}
+
+	for(unsigned int i=0; i<blocks.size(); i++)
+	{
+#if defined(_WIN32)
+		_aligned_free(blocks[i]);
+#else
+		free(blocks[i]);
+#endif
+	}
+
+	// the capacity goes as well, so that a long session does not keep the largest path
+	vector<Allocation>().swap(allocations);
+	vector<cGenericObject*>().swap(nodes);
+	vector<char*>().swap(blocks);
+	cursor		= NULL;
+	remaining	= 0;
+	numBytes	= 0;
+}
+
+//=========================================================//
+
+int PathArena::getNumObjects(void)
+{
+	return (int)allocations.size();
+}
+
+//=========================================================//
+
+long PathArena::getMemorySize(void)
+{
+	return numBytes;
+}
+
+//=========================================================//
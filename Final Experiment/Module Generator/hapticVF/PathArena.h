@@ -0,0 +1,127 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Path Arena]
+Owns everything built for one path: its points, lines, blocks and corners
+are placed one after the other in large blocks of memory, and the scene
+nodes that hang from no fixture, such as the roots of the set, are
+adopted. Nothing of a path is freed on its own; release() destroys the objects in the reverse order of
+their creation, deletes the adopted nodes with their children and gives the
+memory back at once, after which the arena can hold another path.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class PathArena
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	typedef void (*Destructor)(void* object);
+
+	typedef struct Allocation{
+
+	public:
+		void*		object;
+		Destructor	destructor;
+
+	};
+
+	//========================[VARIABLES]======================//
+	vector<char*>			blocks;			// of ARENA_BLOCK_SIZE bytes, or one per larger object
+	char*					cursor;			// the free space of the last block
+	size_t					remaining;
+	vector<Allocation>		allocations;	// in the order of creation
+	vector<cGenericObject*>	nodes;			// adopted, deleted after the objects
+	long					numBytes;
+
+	//========================[METHODS]========================//
+	// not copyable, the objects are owned
+	PathArena(const PathArena&);
+	PathArena& operator=(const PathArena&);
+
+	// uninitialized memory for an object, aligned for SSE
+	void*		allocate(size_t size);
+	// the object is destroyed by release()
+	void		track(void* object, Destructor destructor);
+
+	template<class T>
+	static void	destroy(void* object);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor
+	PathArena(void);
+	// destructor; releases the path
+	~PathArena(void);
+
+	// constructs an object in the arena; it lives until release()
+	template<class T>
+	T*				create(void);
+	template<class T, class A>
+	T*				create(const A& a);
+	template<class T, class A, class B>
+	T*				create(const A& a, const B& b);
+
+	// takes a scene node; release() takes it out of its parent, if any, and deletes it
+	// with its children. Returns the node
+	cGenericObject*	adopt(cGenericObject* node);
+	// destroys the objects and deletes the adopted nodes; the arena is empty afterwards
+	void			release(void);
+
+	//========================[METHODS]===setters & getters====//
+	int				getNumObjects(void);
+	// bytes of the blocks
+	long			getMemorySize(void);
+};
+
+//=========================================================//
+
+template<class T>
+void PathArena::destroy(void* object)
+{
+	((T*)object)->~T();
+}
+
+//=========================================================//
+
+template<class T>
+T* PathArena::create(void)
+{
+	T* object = new(allocate(sizeof(T))) T();
+	track(object, destroy<T>);
+	return object;
+}
+
+//=========================================================//
+
+template<class T, class A>
+T* PathArena::create(const A& a)
+{
+	T* object = new(allocate(sizeof(T))) T(a);
+	track(object, destroy<T>);
+	return object;
+}
+
+//=========================================================//
+
+template<class T, class A, class B>
+T* PathArena::create(const A& a, const B& b)
+{
+	T* object = new(allocate(sizeof(T))) T(a, b);
+	track(object, destroy<T>);
+	return object;
+}
@@ -0,0 +1,209 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Path Progress]
+Where the tool is along the path, measured on the polyline of its waypoints:
+the segment it is closest to, the arc length travelled from the starting
+point, the fraction of the path completed and the lateral distance from the
+path. The tool moves little between two haptic ticks, so each update starts
+from the segment of the previous tick and only steps to a neighbouring
+segment while that one is closer.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+PathProgress::PathProgress(void)
+{
+	totalLength = 0;
+	reset();
+}
+
+//=========================================================//
+
+void PathProgress::build(Point* points, int numOfPoints)
+{
+	segments.clear();
+	totalLength = 0;
+
+	Point* point = points;
+	for(int i=0; i<numOfPoints-1 && point!=NULL && point->next!=NULL; i++)
+	{
+		PathSegment pathSegment;
+		cVector3d vector		= point->next->point - point->point;
+		pathSegment.start		= point->point;
+		pathSegment.length		= vector.length();
+		pathSegment.arcLength	= totalLength;
+		if(pathSegment.length > 0)
+			pathSegment.direction = vector * (1.0 / pathSegment.length);
+		else
+			pathSegment.direction.zero();
+
+		segments.push_back(pathSegment);
+		totalLength += pathSegment.length;
+		point = point->next;
+	}
+
+	reset();
+}
+
+//=========================================================//
+
+void PathProgress::reset(void)
+{
+	segment			= 0;
+	segmentLength	= 0;
+	deviation		= 0;
+
+	if(segments.empty())
+		closestPoint.zero();
+	else
+		closestPoint = segments[0].start;
+}
+
+//=========================================================//
+
+void PathProgress::update(cVector3d position)
+{
+	if(segments.empty())
+		return;
+
+	int		last = (int)segments.size() - 1;
+	double	along;
+	double	distance = getDistance(segment, position, along);
+	double	nextAlong;
+	bool	hasMoved = false;
+
+	// forwards first, as the tool normally travels in that direction
+	while(segment < last)
+	{
+		double nextDistance = getDistance(segment + 1, position, nextAlong);
+		if(nextDistance >= distance)
+			break;
+
+		segment++;
+		distance	= nextDistance;
+		along		= nextAlong;
+		hasMoved	= true;
+	}
+
+	while(!hasMoved && segment > 0)
+	{
+		double prevDistance = getDistance(segment - 1, position, nextAlong);
+		if(prevDistance >= distance)
+			break;
+
+		segment--;
+		distance	= prevDistance;
+		along		= nextAlong;
+	}
+
+	segmentLength	= along;
+	deviation		= distance;
+	closestPoint	= segments[segment].start + segments[segment].direction * along;
+}
+
+//=========================================================//
+
+double PathProgress::getDistance(int index, const cVector3d& position, double& along)
+{
+	const PathSegment& pathSegment = segments[index];
+	cVector3d offset = position - pathSegment.start;
+
+	along = offset.dot(pathSegment.direction);
+	if(along < 0)
+		along = 0;
+	else if(along > pathSegment.length)
+		along = pathSegment.length;
+
+	return (offset - pathSegment.direction * along).length();
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+int PathProgress::getNumSegments(void)
+{
+	return (int)segments.size();
+}
+
+//=========================================================//
+
+double PathProgress::getSegmentArcLength(int index)
+{
+	return segments[index].arcLength;
+}
+
+//=========================================================//
+
+double PathProgress::getSegmentLength(int index)
+{
+	return segments[index].length;
+}
+
+
+//=========================================================//
+
+int PathProgress::getSegment(void)
+{
+	return segment;
+}
+
+//=========================================================//
+
+double PathProgress::getArcLength(void)
+{
+	if(segments.empty())
+		return 0;
+
+	return segments[segment].arcLength + segmentLength;
+}
+
+//=========================================================//
+
+double PathProgress::getTotalLength(void)
+{
+	return totalLength;
+}
+
+//=========================================================//
+
+double PathProgress::getProgress(void)
+{
+	if(totalLength <= 0)
+		return 0;
+
+	return getArcLength() / totalLength;
+}
+
+//=========================================================//
+
+double PathProgress::getDeviation(void)
+{
+	return deviation;
+}
+
+//=========================================================//
+
+cVector3d PathProgress::getClosestPoint(void)
+{
+	return closestPoint;
+}
+
+//=========================================================//
@@ -0,0 +1,82 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Path Progress]
+Where the tool is along the path, measured on the polyline of its waypoints:
+the segment it is closest to, the arc length travelled from the starting
+point, the fraction of the path completed and the lateral distance from the
+path. The tool moves little between two haptic ticks, so each update starts
+from the segment of the previous tick and only steps to a neighbouring
+segment while that one is closer.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+typedef struct PathSegment{
+
+public:
+	cVector3d	start;
+	cVector3d	direction;		// unit vector from start to end
+	double		length;
+	double		arcLength;		// arc length of the path at start
+
+};
+
+class PathProgress
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<PathSegment>	segments;		// from the starting point to the end of the path
+	double				totalLength;
+
+	int					segment;		// closest segment at the last update
+	double				segmentLength;	// distance along it of the closest point
+	double				deviation;
+	cVector3d			closestPoint;
+
+	//========================[METHODS]========================//
+	// distance from the position to a segment and the distance along it of the closest point
+	double		getDistance(int index, const cVector3d& position, double& along);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; an empty path reports no progress
+	PathProgress(void);
+	// builds the segments between the first numOfPoints waypoints of the list
+	void		build(Point* points, int numOfPoints);
+	// goes back to the starting point
+	void		reset(void);
+	// follows the tool from its position at the last update; call once per tick
+	void		update(cVector3d position);
+
+	//========================[METHODS]===setters & getters====//
+	int			getNumSegments(void);
+	// arc length of the path at the start of a segment, and the length of the segment
+	double		getSegmentArcLength(int index);
+	double		getSegmentLength(int index);
+
+	// index of the closest segment, from 0 at the starting point
+	int			getSegment(void);
+	double		getArcLength(void);
+	double		getTotalLength(void);
+	// fraction of the arc length of the path travelled, between 0 and 1
+	double		getProgress(void);
+	// distance from the tool to the closest point of the path
+	double		getDeviation(void);
+	cVector3d	getClosestPoint(void);
+};
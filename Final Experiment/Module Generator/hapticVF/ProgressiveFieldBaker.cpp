@@ -0,0 +1,149 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Progressive Field Baker]
+Bakes the distance field of the model level by level, from a coarse grid
+that is ready in a fraction of a second to the full resolution, and hands
+each level to the haptic loop as soon as it is done: the walls can be felt
+early and sharpen while the session goes on.
+A level is published by swapping one pointer. The haptic thread picks up the
+latest level once per tick and tells the baker which levels it has seen, so
+a replaced level is only deleted once the haptic thread can no longer be
+reading it.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+ProgressiveFieldBaker::ProgressiveFieldBaker(void)
+{
+	current			= NULL;
+	numPublished	= 0;
+	numAcquired		= 0;
+}
+
+//=========================================================//
+
+ProgressiveFieldBaker::~ProgressiveFieldBaker(void)
+{
+	for(unsigned int i=0; i<retired.size(); i++)
+		delete retired[i].field;
+
+	delete (SignedDistanceField*)current;
+}
+
+//=========================================================//
+
+void ProgressiveFieldBaker::bake(cMesh* mesh, int resolution, double bandWidth, string cacheFileName)
+{
+	long long start = getMonotonicNanoseconds();
+
+	// the coarse levels are skipped when the last one is in the cache
+	vector<int> resolutions;
+	SignedDistanceField* cached = new SignedDistanceField();
+	if(cached->loadCached(mesh, resolution, bandWidth, cacheFileName))
+		resolutions.push_back(resolution);
+	else
+	{
+		delete cached;
+		cached = NULL;
+		for(int levelResolution = resolution; levelResolution >= COARSEST_RESOLUTION; levelResolution /= 2)
+			resolutions.insert(resolutions.begin(), levelResolution);
+		if(resolutions.empty())
+			resolutions.push_back(resolution);
+	}
+
+	for(unsigned int level=0; level<resolutions.size(); level++)
+	{
+		SignedDistanceField* field = cached;
+		bool isLastLevel = (level + 1 == resolutions.size());
+
+		if(field == NULL)
+		{
+			field = new SignedDistanceField();
+			bool isBaked = isLastLevel ?
+				field->bakeCached(mesh, resolutions[level], bandWidth, cacheFileName) :
+				field->bake(mesh, resolutions[level], bandWidth);
+			if(!isBaked)
+			{
+				printf("Error - the distance field of the model could not be baked.\n");
+				delete field;
+				break;
+			}
+		}
+
+		printf("Distance field level %d of %d: voxels of %.4f, %d of %d bricks near the surface (%.1f MB) after %.0f ms\n",
+			level + 1, (int)resolutions.size(), field->getVoxelSize(), field->getNumPoolBricks(), field->getNumBricks(),
+			field->getMemorySize() / 1048576.0, 1000 * nanosecondsToSeconds(getMonotonicNanoseconds() - start));
+
+		publish(field);
+		reclaim();
+	}
+
+	// the reader acknowledges within a tick; give up after a while if the haptic loop has stopped
+	for(int i=0; i<1000 && !reclaim(); i++)
+		cSleepMs(1);
+}
+
+//=========================================================//
+
+void ProgressiveFieldBaker::publish(SignedDistanceField* field)
+{
+	// the pointer first: a reader that sees the new count also sees this level or a later one
+	SignedDistanceField* previous = (SignedDistanceField*)atomicExchangePointer(&current, field);
+	long published = atomicIncrement(&numPublished);
+
+	if(previous != NULL)
+	{
+		RetiredField retiredField;
+		retiredField.field			= previous;
+		retiredField.numPublished	= published;
+		retired.push_back(retiredField);
+	}
+}
+
+//=========================================================//
+
+bool ProgressiveFieldBaker::reclaim(void)
+{
+	long acquired = atomicLoad(&numAcquired);
+
+	for(unsigned int i=0; i<retired.size(); )
+	{
+		if(retired[i].numPublished <= acquired)
+		{
+			delete retired[i].field;
+			retired.erase(retired.begin() + i);
+		}
+		else
+			i++;
+	}
+
+	return retired.empty();
+}
+
+//=========================================================//
+
+SignedDistanceField* ProgressiveFieldBaker::acquire(void)
+{
+	// the count first: the level loaded after it is at least the one it counts
+	long published = atomicLoad(&numPublished);
+	SignedDistanceField* field = (SignedDistanceField*)atomicLoadPointer(&current);
+	atomicStore(&numAcquired, published);
+
+	return field;
+}
+
+//=========================================================//
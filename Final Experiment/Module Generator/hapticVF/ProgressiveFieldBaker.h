@@ -0,0 +1,72 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Progressive Field Baker]
+Bakes the distance field of the model level by level, from a coarse grid
+that is ready in a fraction of a second to the full resolution, and hands
+each level to the haptic loop as soon as it is done: the walls can be felt
+early and sharpen while the session goes on.
+A level is published by swapping one pointer. The haptic thread picks up the
+latest level once per tick and tells the baker which levels it has seen, so
+a replaced level is only deleted once the haptic thread can no longer be
+reading it.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class ProgressiveFieldBaker
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	// a level replaced by a finer one, kept until the reader has moved on
+	struct RetiredField
+	{
+		SignedDistanceField*	field;
+		long					numPublished;	// levels published once it was replaced
+	};
+
+	void* volatile			current;			// the finest level so far, a SignedDistanceField
+	volatile long			numPublished;		// levels published so far
+	volatile long			numAcquired;		// value of numPublished when the reader last acquired
+	vector<RetiredField>	retired;			// baking thread only
+
+	static const int		COARSEST_RESOLUTION = 32;
+
+	//========================[METHODS]========================//
+	// makes the field the current level
+	void		publish(SignedDistanceField* field);
+	// deletes the retired levels the reader has moved on from; returns true if none is left
+	bool		reclaim(void);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor
+	ProgressiveFieldBaker(void);
+	// destructor; only once nothing is baking or reading
+	~ProgressiveFieldBaker(void);
+
+	//========================[METHODS]=====baker (workers)====//
+	// bakes the levels in the calling thread, doubling the resolution up to the given one;
+	// the last level is read from the cache file if it holds it, and saved there otherwise
+	void					bake(cMesh* mesh, int resolution, double bandWidth, string cacheFileName);
+
+	//========================[METHODS]=====reader (haptics)===//
+	// the latest level, NULL until the first one is baked; call once per tick and do not
+	// use the field returned by the previous call any more
+	SignedDistanceField*	acquire(void);
+};
@@ -0,0 +1,242 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Scene Command Queue]
+A lock-free single-producer/single-consumer queue of scene graph changes.
+The haptic thread never edits the scene graph used for rendering; it queues
+the visual changes here and the graphics thread applies them at the start
+of its next frame, or between frames from a timer when none is drawn.
+Adding or removing nodes also changes the lists the haptic thread walks for
+collisions, so while such a command is pending the haptic thread keeps off the
+scene graph (see isStructureChangePending).
+The haptic thread does not lock, so the tasks it has for the worker pool go
+through the queue as well; the graphics thread submits them. Other threads
+that wait for the graphics thread to apply a change sleep on an event.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+SceneCommandQueue::SceneCommandQueue(int capacity)
+{
+	unsigned long size = 1;
+	while(size < (unsigned long)capacity)
+		size = size << 1;
+
+	commands.resize(size);
+	mask		= size - 1;
+	head		= 0;
+	tail		= 0;
+	numDropped	= 0;
+
+	numStructuralQueued		= 0;
+	numStructuralApplied	= 0;
+}
+
+//=========================================================//
+
+bool SceneCommandQueue::push(const SceneCommand& command)
+{
+	unsigned long writeIndex	= (unsigned long)head;
+	unsigned long readIndex		= (unsigned long)atomicLoad(&tail);
+
+	if(writeIndex - readIndex > mask)
+	{
+		numDropped++;
+		return false;
+	}
+
+	commands[writeIndex & mask] = command;
+
+	// publishing the index after the slot makes the command visible as a whole
+	atomicStore(&head, (long)(writeIndex + 1));
+	return true;
+}
+
+//=========================================================//
+
+void SceneCommandQueue::applyAll(void)
+{
+	unsigned long readIndex		= (unsigned long)tail;
+	unsigned long writeIndex	= (unsigned long)atomicLoad(&head);
+	bool isStructureChanged		= false;
+
+	while(readIndex != writeIndex)
+	{
+		const SceneCommand& command = commands[readIndex & mask];
+		if(command.type == SCENE_ADD_CHILD || command.type == SCENE_REMOVE_CHILD)
+			isStructureChanged = true;
+		apply(command);
+		readIndex++;
+	}
+
+	atomicStore(&tail, (long)readIndex);
+
+	if(isStructureChanged)
+		structureApplied.set();
+}
+
+//=========================================================//
+
+void SceneCommandQueue::apply(const SceneCommand& command)
+{
+	switch(command.type)
+	{
+		case SCENE_ADD_CHILD:
+			command.target->addChild(command.child);
+			atomicIncrement(&numStructuralApplied);
+			break;
+		case SCENE_REMOVE_CHILD:
+			command.target->removeChild(command.child);
+			atomicIncrement(&numStructuralApplied);
+			break;
+		case SCENE_SHOW:
+			command.target->setShowEnabled(command.status, true);
+			break;
+		case SCENE_SET_TRANSPARENCY:
+			command.target->setTransparencyLevel(command.value, true, true);
+			break;
+		case SCENE_SET_AMBIENT_COLOR:
+			applyAmbientColor(command.target, command.color);
+			break;
+		case SCENE_SUBMIT_TASK:
+			WorkerPool::getInstance()->submit(command.task, command.arg, command.group);
+			break;
+	}
+}
+
+//=========================================================//
+
+void SceneCommandQueue::applyAmbientColor(cGenericObject* object, cColorf color)
+{
+	cMesh* mesh = dynamic_cast<cMesh*>(object);
+	if(mesh != NULL)
+		mesh->m_material.m_ambient.set(color.getR(), color.getG(), color.getB(),
+			mesh->m_material.m_ambient.getA());
+
+	for(unsigned int i=0; i<object->getNumChildren(); i++)
+		applyAmbientColor(object->getChild(i), color);
+}
+
+//=========================================================//
+
+bool SceneCommandQueue::isStructureChangePending(void)
+{
+	return atomicLoad(&numStructuralApplied) != atomicLoad(&numStructuralQueued);
+}
+
+//=========================================================//
+
+long SceneCommandQueue::getNumDropped(void)
+{
+	return numDropped;
+}
+
+//=========================================================//
+
+void SceneCommandQueue::waitForStructureChanges(void)
+{
+	while(true)
+	{
+		// cleared before looking, so that a frame applying the change from now on is not missed
+		structureApplied.reset();
+		if(!isStructureChangePending())
+			return;
+		structureApplied.wait();
+	}
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================PRODUCER METHODS=======================//
+//=========================================================*/
+
+void SceneCommandQueue::addChild(cGenericObject* parent, cGenericObject* child)
+{
+	SceneCommand command;
+	command.type	= SCENE_ADD_CHILD;
+	command.target	= parent;
+	command.child	= child;
+
+	// counted before it is queued so the haptic thread is already parked when it is applied
+	atomicIncrement(&numStructuralQueued);
+	if(!push(command))
+		atomicAdd(&numStructuralQueued, -1);
+}
+
+//=========================================================//
+
+void SceneCommandQueue::removeChild(cGenericObject* parent, cGenericObject* child)
+{
+	SceneCommand command;
+	command.type	= SCENE_REMOVE_CHILD;
+	command.target	= parent;
+	command.child	= child;
+
+	// counted before it is queued so the haptic thread is already parked when it is applied
+	atomicIncrement(&numStructuralQueued);
+	if(!push(command))
+		atomicAdd(&numStructuralQueued, -1);
+}
+
+//=========================================================//
+
+void SceneCommandQueue::setShowEnabled(cGenericObject* object, bool status)
+{
+	SceneCommand command;
+	command.type	= SCENE_SHOW;
+	command.target	= object;
+	command.status	= status;
+	push(command);
+}
+
+//=========================================================//
+
+void SceneCommandQueue::setTransparencyLevel(cGenericObject* object, double level)
+{
+	SceneCommand command;
+	command.type	= SCENE_SET_TRANSPARENCY;
+	command.target	= object;
+	command.value	= level;
+	push(command);
+}
+
+//=========================================================//
+
+void SceneCommandQueue::setAmbientColor(cGenericObject* object, cColorf color)
+{
+	SceneCommand command;
+	command.type	= SCENE_SET_AMBIENT_COLOR;
+	command.target	= object;
+	command.color	= color;
+	push(command);
+}
+
+//=========================================================//
+
+bool SceneCommandQueue::submitTask(WorkerTask task, void* arg, WorkerGroup* group)
+{
+	SceneCommand command;
+	command.type	= SCENE_SUBMIT_TASK;
+	command.target	= NULL;
+	command.task	= task;
+	command.arg		= arg;
+	command.group	= group;
+	return push(command);
+}
+
+//=========================================================//
@@ -0,0 +1,105 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Scene Command Queue]
+A lock-free single-producer/single-consumer queue of scene graph changes.
+The haptic thread never edits the scene graph used for rendering; it queues
+the visual changes here and the graphics thread applies them at the start
+of its next frame, or between frames from a timer when none is drawn.
+Adding or removing nodes also changes the lists the haptic thread walks for
+collisions, so while such a command is pending the haptic thread keeps off the
+scene graph (see isStructureChangePending).
+The haptic thread does not lock, so the tasks it has for the worker pool go
+through the queue as well; the graphics thread submits them. Other threads
+that wait for the graphics thread to apply a change sleep on an event.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+enum SceneCommandType
+{
+	SCENE_ADD_CHILD,
+	SCENE_REMOVE_CHILD,
+	SCENE_SHOW,
+	SCENE_SET_TRANSPARENCY,
+	SCENE_SET_AMBIENT_COLOR,
+	SCENE_SUBMIT_TASK
+};
+
+typedef struct SceneCommand{
+
+public:
+	SceneCommandType	type;
+	cGenericObject*		target;
+	cGenericObject*		child;
+	bool				status;
+	double				value;
+	cColorf				color;
+	WorkerTask			task;
+	void*				arg;
+	WorkerGroup*		group;
+
+};
+
+class SceneCommandQueue
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<SceneCommand>	commands;
+	unsigned long			mask;
+	volatile long			head;			// next slot to write, producer only
+	volatile long			tail;			// next slot to read, consumer only
+	long					numDropped;
+	volatile long			numStructuralQueued;	// add/remove commands queued, producer only
+	volatile long			numStructuralApplied;	// add/remove commands applied, consumer only
+	ThreadEvent				structureApplied;		// signaled after a frame that applied add/remove commands
+
+	//========================[METHODS]========================//
+	// queues a command; returns false (and counts it) if the queue is full
+	bool		push(const SceneCommand& command);
+	// performs one command on the scene graph
+	void		apply(const SceneCommand& command);
+	// sets the ambient color of every mesh under the object, keeping alpha
+	void		applyAmbientColor(cGenericObject* object, cColorf color);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the capacity is rounded up to a power of two
+	SceneCommandQueue(int capacity);
+
+	//========================[METHODS]=====producer (haptics)=//
+	void		addChild(cGenericObject* parent, cGenericObject* child);
+	void		removeChild(cGenericObject* parent, cGenericObject* child);
+	void		setShowEnabled(cGenericObject* object, bool status);
+	void		setTransparencyLevel(cGenericObject* object, double level);
+	void		setAmbientColor(cGenericObject* object, cColorf color);
+	// queues a task for the worker pool, in the group if any; returns false if the queue is full
+	bool		submitTask(WorkerTask task, void* arg, WorkerGroup* group = NULL);
+	// true from the moment an add/remove is queued until the graphics thread has applied it
+	bool		isStructureChangePending(void);
+
+	//========================[METHODS]=====consumer (graphics)//
+	// applies every queued command; call at the start of the frame, or between frames
+	void		applyAll(void);
+	// number of commands lost because the queue was full
+	long		getNumDropped(void);
+
+	//========================[METHODS]=========any thread=====//
+	// blocks until the graphics thread has applied every add/remove queued so far
+	void		waitForStructureChanges(void);
+};
@@ -0,0 +1,126 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Session Event Queue]
+A lock-free single-producer/single-consumer queue of the events of a trial,
+from the haptic thread (producer) to the session service (consumer). Pushing
+never blocks, so the haptic loop does no I/O and never waits for the console.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+SessionEventQueue::SessionEventQueue(int capacity)
+{
+	unsigned long size = 1;
+	while(size < (unsigned long)capacity)
+		size = size << 1;
+
+	events.resize(size);
+	mask		= size - 1;
+	head		= 0;
+	tail		= 0;
+	numDropped	= 0;
+}
+
+//=========================================================//
+
+bool SessionEventQueue::push(SessionEventType type, long long time)
+{
+	return push(type, time, cVector3d(0, 0, 0), 0, 0);
+}
+
+//=========================================================//
+
+bool SessionEventQueue::push(SessionEventType type, long long time, int segment, double peakForce)
+{
+	SessionEvent event;
+	event.type		= type;
+	event.time		= time;
+	event.segment	= segment;
+	event.peakForce	= peakForce;
+	event.force.zero();
+	event.progress	= 0;
+	event.deviation	= 0;
+	return push(event);
+}
+
+//=========================================================//
+
+bool SessionEventQueue::push(SessionEventType type, long long time, cVector3d force, double progress, double deviation)
+{
+	SessionEvent event;
+	event.type		= type;
+	event.time		= time;
+	event.segment	= -1;
+	event.peakForce	= 0;
+	event.force		= force;
+	event.progress	= progress;
+	event.deviation	= deviation;
+	return push(event);
+}
+
+//=========================================================//
+
+bool SessionEventQueue::push(const SessionEvent& event)
+{
+	unsigned long writeIndex	= (unsigned long)head;
+	unsigned long readIndex		= (unsigned long)atomicLoad(&tail);
+
+	if(writeIndex - readIndex > mask)
+	{
+		atomicIncrement(&numDropped);
+		return false;
+	}
+
+	events[writeIndex & mask] = event;
+
+	// publishing the index after the slot makes the event visible as a whole
+	atomicStore(&head, (long)(writeIndex + 1));
+	return true;
+}
+
+//=========================================================//
+
+long SessionEventQueue::getNumPushed(void)
+{
+	return head;
+}
+
+//=========================================================//
+
+bool SessionEventQueue::pop(SessionEvent& event)
+{
+	unsigned long readIndex		= (unsigned long)tail;
+	unsigned long writeIndex	= (unsigned long)atomicLoad(&head);
+
+	if(readIndex == writeIndex)
+		return false;
+
+	event = events[readIndex & mask];
+
+	// the slot may be reused once the index has moved on
+	atomicStore(&tail, (long)(readIndex + 1));
+	return true;
+}
+
+//=========================================================//
+
+long SessionEventQueue::getNumDropped(void)
+{
+	return atomicLoad(&numDropped);
+}
+
+//=========================================================//
@@ -0,0 +1,84 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Session Event Queue]
+A lock-free single-producer/single-consumer queue of the events of a trial,
+from the haptic thread (producer) to the session service (consumer). Pushing
+never blocks, so the haptic loop does no I/O and never waits for the console.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+enum SessionEventType
+{
+	SESSION_PATH_ENTERED,		// the tool entered the second segment: a trial starts
+	SESSION_PATH_EXITED,		// the tool left the last segment: the trial ends
+	SESSION_SEGMENT_ENTERED,	// the guidance of a segment turned on
+	SESSION_SEGMENT_EXITED,		// the guidance of a segment turned off
+	SESSION_COLLISION_ENDED		// the tool left a block wall it had hit
+};
+
+typedef struct SessionEvent{
+
+public:
+	SessionEventType	type;
+	long long			time;		// when it happened in the haptic loop [ns]
+	int					segment;	// SESSION_SEGMENT_*: index of the line in its fixture set
+	double				peakForce;	// SESSION_SEGMENT_EXITED: largest force inside the segment
+	cVector3d			force;		// SESSION_COLLISION_ENDED: the force when leaving the wall
+	double				progress;	// SESSION_COLLISION_ENDED: fraction of the path travelled
+	double				deviation;	// SESSION_COLLISION_ENDED: distance from the path
+
+};
+
+class SessionEventQueue
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<SessionEvent>	events;
+	unsigned long			mask;
+	volatile long			head;			// next slot to write, producer only
+	volatile long			tail;			// next slot to read, consumer only
+	volatile long			numDropped;
+
+	//========================[METHODS]========================//
+	// queues an event; returns false (and counts it) if the queue is full
+	bool		push(const SessionEvent& event);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the capacity is rounded up to a power of two
+	SessionEventQueue(int capacity);
+
+	//========================[METHODS]=====producer (haptics)=//
+	// the path events
+	bool		push(SessionEventType type, long long time);
+	// the segment events
+	bool		push(SessionEventType type, long long time, int segment, double peakForce);
+	// the collision events
+	bool		push(SessionEventType type, long long time, cVector3d force, double progress, double deviation);
+
+	// number of events queued so far; only grows
+	long		getNumPushed(void);
+
+	//========================[METHODS]=====consumer (session)=//
+	// takes the oldest event; returns false if there is none
+	bool		pop(SessionEvent& event);
+	// number of events lost because the queue was full
+	long		getNumDropped(void);
+};
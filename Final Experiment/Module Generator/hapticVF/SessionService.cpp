@@ -0,0 +1,315 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Session Service]
+Owns everything about the trials of a module that is not real-time: the trial
+count, the timing and collision totals, the output files and the prompts to
+the tester. It runs on the runner thread and consumes the events the haptic
+loop queues when the tool enters or leaves the path (see SessionEventQueue).
+When a module ends the haptic loop is parked at zero force before the tester
+is asked for anything. Between events the runner thread sleeps on an event
+instead of polling.
+This is a singleton class.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+bool				SessionService::instanceFlag	= false;
+SessionService*		SessionService::single			= NULL;
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+SessionService::SessionService(void)
+{
+	values					= CommonValues::getInstance();
+	fixtureSet				= NULL;
+	isModuleRunning			= false;
+
+	isEndRequested			= 0;
+	isTrialResetRequested	= 0;
+	isParkRequested			= 0;
+	isHapticsParked			= 0;
+	isHapticsStopped		= 0;
+	numSignaledEvents		= 0;
+}
+
+//=========================================================//
+
+SessionService* SessionService::getInstance(void)
+{
+	if(!instanceFlag)
+	{
+		single = new SessionService();
+		instanceFlag = true;
+		return single;
+	}
+	else
+	{
+		return single;
+	}
+}
+
+//=========================================================//
+
+void SessionService::beginModule(FixtureSet* fixtureSet)
+{
+	// whatever the previous module left in the queue is not part of this one
+	SessionEvent event;
+	while(values->sessionEvents->pop(event));
+
+	this->fixtureSet		= fixtureSet;
+	values->trials			= 1;
+	metrics.reset();
+
+	atomicStore(&isEndRequested, 0);
+	atomicStore(&isTrialResetRequested, 0);
+	atomicStore(&isHapticsParked, 0);
+	atomicStore(&isParkRequested, 0);
+}
+
+//=========================================================//
+
+void SessionService::runModule(void)
+{
+	SessionEvent event;
+
+	isModuleRunning = true;
+	while(isModuleRunning)
+	{
+		// cleared before looking, so that a signal from now on is not lost
+		wakeUp.reset();
+
+		while(isModuleRunning && values->sessionEvents->pop(event))
+			handleEvent(event);
+
+		if(atomicExchange(&isTrialResetRequested, 0))
+			resetTrials();
+
+		if(isModuleRunning && atomicExchange(&isEndRequested, 0))
+		{
+			parkHaptics();
+			outfileForces.close();
+			isModuleRunning = false;
+		}
+
+		if(isModuleRunning)
+			wakeUp.wait();
+	}
+}
+
+//=========================================================//
+
+void SessionService::handleEvent(const SessionEvent& event)
+{
+	switch(event.type)
+	{
+		case SESSION_PATH_ENTERED:
+			startTrial(event.time);
+			break;
+		case SESSION_PATH_EXITED:
+			endTrial(event.time);
+			break;
+		case SESSION_SEGMENT_ENTERED:
+			metrics.enterSegment(event.segment, event.time);
+			break;
+		case SESSION_SEGMENT_EXITED:
+			metrics.exitSegment(event.segment, event.time, event.peakForce);
+			break;
+		case SESSION_COLLISION_ENDED:
+			metrics.addCollision();
+			if(outfileForces.is_open())
+				outfileForces<<event.force.x<<" "<<event.force.y<<" "<<event.force.z<<" "<<event.progress<<" "<<event.deviation<<endl;
+			break;
+	}
+}
+
+//=========================================================//
+
+void SessionService::startTrial(long long time)
+{
+	stringstream ss;
+	ss << values->trials;
+	string trialNum = ss.str();
+	string extension = ".txt";
+	string fileName = "../Debug/OUTPUT_FORCES_" + fixtureSet->config.name + string("_trial") + trialNum + extension;
+
+	outfileForces.close();
+	outfileForces.open((fileName));
+	metrics.startTrial(time);
+}
+
+//=========================================================//
+
+void SessionService::endTrial(long long time)
+{
+	bool isTutorialModule = fixtureSet->config.isTutorialModule;
+
+	metrics.endTrial(time);
+	outfileForces.close();
+
+	if(fixtureSet->numOfMidPoints>2)
+	{
+		if(!isTutorialModule)values->trials = metrics.getNumTrials() + 1;
+		if(!isTutorialModule && metrics.getNumTrials()>=values->numOfTrials)
+		{
+			// the device is released before the tester is asked anything
+			parkHaptics();
+			rateModule();
+			isModuleRunning = false;
+		}else
+			if(!isTutorialModule)printf("Trial # %d\nPlease change the orientation to perform the next trial.\nTo change the orientation, press the haptic switch and move the camera around.\n", values->trials);
+	}
+}
+
+//=========================================================//
+
+void SessionService::resetTrials(void)
+{
+	if(fixtureSet == NULL || fixtureSet->config.isTutorialModule)
+		return;
+
+	values->trials = 1;
+	metrics.reset();
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	printf("Number of trials is reset\n");
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	printf("Trial # %d\n", values->trials);
+}
+
+//=========================================================//
+
+void SessionService::rateModule(void)
+{
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	cout<<"Thank you for your patience."<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+	cout<<"Please rate the effectivenes of guidance of this module."<<endl;
+	cout<<"Effectivenss of guidance: the easieness of navigating from"<<endl;
+	cout<<"the beginning till the end with the highest accuracy in the"<<endl;
+	cout<<"shortest time period."<<endl;
+	cout<<"Please enter the number corresponding to your rating:"<<endl;
+	cout<<"[5] - Excellent"<<endl;
+	cout<<"[4] - Very Good"<<endl;
+	cout<<"[3] - Good"<<endl;
+	cout<<"[2] - Not Bad"<<endl;
+	cout<<"[1] - Poor"<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+
+	int rating;
+	cin>>rating;
+	cout<<endl;
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+
+	string fileName;
+	string extension = ".txt";
+
+	fileName = "../Debug/OUTPUT_VALUES_" + fixtureSet->config.name + extension;
+
+	// the times are measured in nanoseconds; microseconds are kept in the file
+	outfileCollisionTime.open((fileName));
+	outfileCollisionTime<<fixed<<setprecision(6);
+	for(int i=0; i<metrics.getNumTrials(); i++)
+	{
+		TrialRecord trial = metrics.getTrial(i);
+		outfileCollisionTime<<"Total Time"<<(i + 1)<<": "<<trial.getTotalTime()<<" , ";
+		outfileCollisionTime<<"Collisions"<<(i + 1)<<": "<<trial.numOfCollisions<<endl;
+	}
+	outfileCollisionTime<<"Average Total Time: "<<metrics.getAverageTime()<<" , ";
+	outfileCollisionTime<<"Average Total Num of Collisions: "<<metrics.getAverageNumCollisions()<<endl;
+	outfileCollisionTime<<"Rating: "<<rating<<endl;
+	outfileCollisionTime.close();
+
+	fileName = "../Debug/OUTPUT_SEGMENTS_" + fixtureSet->config.name + extension;
+
+	outfileSegments.open((fileName));
+	metrics.writeSegments(outfileSegments);
+	outfileSegments.close();
+
+	cout<<"Module [" << fixtureSet->config.name << "] has ended.\n";
+	cout<<"+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++"<<endl;
+}
+
+//=========================================================//
+
+void SessionService::parkHaptics(void)
+{
+	atomicStore(&isParkRequested, 1);
+
+	while(true)
+	{
+		wakeUp.reset();
+		if(atomicLoad(&isHapticsParked) || atomicLoad(&isHapticsStopped))
+			return;
+		wakeUp.wait();
+	}
+}
+
+//=========================================================//
+
+void SessionService::requestModuleEnd(void)
+{
+	atomicStore(&isEndRequested, 1);
+	wakeUp.set();
+}
+
+//=========================================================//
+
+void SessionService::requestTrialReset(void)
+{
+	atomicStore(&isTrialResetRequested, 1);
+	wakeUp.set();
+}
+
+//=========================================================//
+
+bool SessionService::getIsParkRequested(void)
+{
+	return atomicLoad(&isParkRequested) != 0;
+}
+
+//=========================================================//
+
+void SessionService::notifyParked(void)
+{
+	// called in every parked tick; only the first one wakes the session
+	if(atomicExchange(&isHapticsParked, 1) == 0)
+		wakeUp.set();
+}
+
+//=========================================================//
+
+void SessionService::notifyEventsQueued(void)
+{
+	// the haptic loop queues a few events per trial, so the event is seldom set from
+	// the haptic thread, and never in a tick that queued nothing
+	long numPushed = values->sessionEvents->getNumPushed();
+	if(numPushed != numSignaledEvents)
+	{
+		numSignaledEvents = numPushed;
+		wakeUp.set();
+	}
+}
+
+//=========================================================//
+
+void SessionService::notifyStopped(void)
+{
+	atomicStore(&isHapticsStopped, 1);
+	wakeUp.set();
+}
+
+//=========================================================//
@@ -0,0 +1,98 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Session Service]
+Owns everything about the trials of a module that is not real-time: the trial
+count, the timing and collision metrics (see TrialMetrics), the output files
+and the prompts to the tester. It runs on the runner thread and consumes the events the haptic
+loop queues when the tool enters or leaves the path (see SessionEventQueue).
+When a module ends the haptic loop is parked at zero force before the tester
+is asked for anything.
+This is a singleton class.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class SessionService
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	static bool				instanceFlag;
+	static SessionService*	single;
+
+	CommonValues*			values;
+	FixtureSet*				fixtureSet;
+	bool					isModuleRunning;
+
+	// trials of the running module
+	TrialMetrics			metrics;
+	ofstream				outfileForces;
+	ofstream				outfileSegments;
+	ofstream				outfileCollisionTime;
+
+	// requests between the threads
+	volatile long			isEndRequested;			// keyboard -> session
+	volatile long			isTrialResetRequested;	// keyboard -> session
+	volatile long			isParkRequested;		// session -> haptics
+	volatile long			isHapticsParked;		// haptics -> session
+	volatile long			isHapticsStopped;		// haptics -> session
+
+	// signaled whenever the session has something to do: events queued, a request,
+	// the haptic loop parked or stopped
+	ThreadEvent				wakeUp;
+	long					numSignaledEvents;		// haptic thread only
+
+	//========================[METHODS]========================//
+	// constructor
+	SessionService(void);
+	void		handleEvent(const SessionEvent& event);
+	void		startTrial(long long time);
+	void		endTrial(long long time);
+	void		resetTrials(void);
+	// asks the tester to rate the module and writes the values of its trials
+	void		rateModule(void);
+	// stops the forces of the module and waits until the haptic loop has done so (or
+	// has stopped)
+	void		parkHaptics(void);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// returns the unique instance of SessionService
+	static SessionService*	getInstance(void);
+
+	//========================[METHODS]=========runner thread==//
+	// resets the trials; call before the fixture set is handed to the haptic loop
+	void		beginModule(FixtureSet* fixtureSet);
+	// handles the events of the module until it ends
+	void		runModule(void);
+
+	//========================[METHODS]=========any thread=====//
+	// ends the running module (the tutorial has no trials to end it)
+	void		requestModuleEnd(void);
+	// starts counting the trials of the running module again
+	void		requestTrialReset(void);
+
+	//========================[METHODS]=========haptic thread==//
+	// true while the haptic loop has to hold the device at zero force
+	bool		getIsParkRequested(void);
+	void		notifyParked(void);
+	// wakes the session if events were queued since the last call; once per tick
+	void		notifyEventsQueued(void);
+	// the haptic loop has ended
+	void		notifyStopped(void);
+};
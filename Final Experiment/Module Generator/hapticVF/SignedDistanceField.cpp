@@ -0,0 +1,717 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Signed Distance Field]
+The signed distance from the surface of the anatomy model, sampled on a
+regular grid around it: negative inside the closed surface, positive outside.
+The haptic loop reads the distance and its gradient with one trilinear
+lookup, so a wall force costs the same whatever the number of triangles of
+the model. The distances are exact within a band around the surface and
+clamped beyond it.
+Only the band is stored: the grid is split in bricks of 8x8x8 voxels, and
+only the bricks the surface passes near get samples, kept in one pool
+aligned on cache lines. A lookup reads the brick table, then the samples of
+one brick, so memory grows with the area of the surface and not with the
+volume around it.
+The grid is baked on all the cores (see WorkerPool) and saved to a cache
+file, which is read back as long as the model and the settings are the same.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+
+static const char	SDF_FILE_TAG[8]		= "HVFSDF2";
+static const int	SDF_BRICK_SIZE		= 8;		// voxels per side of a brick
+static const int	SDF_BRICK_SAMPLES	= 9;		// samples per side; the last ones repeat the first of the next brick
+static const int	SDF_BRICK_STRIDE	= 736;		// floats per brick in the pool: 9x9x9, padded to whole cache lines
+static const int	SDF_CACHE_LINE		= 64;
+static const int	SDF_FAR_OUTSIDE		= -1;		// brick table entries of the bricks away from the surface
+static const int	SDF_FAR_INSIDE		= -2;
+
+// shared data of the bake of one field
+struct SDFBakeJob
+{
+	const vector<cVector3d>*	vertices;		// three per triangle
+	vector<cVector3d>			bounds;			// per triangle, the corners of its bounding box
+	cVector3d					origin;
+	double						voxelSize;
+	double						bandWidth;
+	int							bricksX;
+	int							bricksY;
+	int							bricksZ;
+	int							sizeX;			// samples along x
+	vector<int>					brickOffsets;	// per brick, start of its triangles in brickTriangles
+	vector<int>					brickTriangles;	// triangles within the band of each brick
+	vector<int>					poolBricks;		// the brick of each place of the pool
+	vector<char>				isFarInside;	// per brick away from the surface, the side it is on
+	int*						brickTable;
+	float*						brickPool;
+};
+
+/*=========================================================//
+//==================[HELPER FUNCTIONS]=====================//
+//=========================================================*/
+
+static cVector3d getMaxVector(const cVector3d& a, const cVector3d& b)
+{
+	return cVector3d(cMax(a.x, b.x), cMax(a.y, b.y), cMax(a.z, b.z));
+}
+
+//=========================================================//
+
+static void collectTriangles(cMesh* mesh, const cMatrix3d& rot, const cVector3d& pos, vector<cVector3d>& vertices)
+{
+	vector<cVertex>*	meshVertices	= mesh->pVertices();
+	vector<cTriangle>*	meshTriangles	= mesh->pTriangles();
+
+	for(unsigned int t=0; t<meshTriangles->size(); t++)
+	{
+		cTriangle& triangle = (*meshTriangles)[t];
+		if(!triangle.m_allocated)
+			continue;
+
+		vertices.push_back(cAdd(pos, cMul(rot, (*meshVertices)[triangle.getIndexVertex0()].getPos())));
+		vertices.push_back(cAdd(pos, cMul(rot, (*meshVertices)[triangle.getIndexVertex1()].getPos())));
+		vertices.push_back(cAdd(pos, cMul(rot, (*meshVertices)[triangle.getIndexVertex2()].getPos())));
+	}
+
+	for(unsigned int i=0; i<mesh->getNumChildren(); i++)
+	{
+		cMesh* child = dynamic_cast<cMesh*>(mesh->getChild(i));
+		if(child != NULL)
+			collectTriangles(child, cMul(rot, child->getRot()), cAdd(pos, cMul(rot, child->getPos())), vertices);
+	}
+}
+
+//=========================================================//
+
+// FNV-1a over the bytes, continuing from the given hash
+static unsigned long long hashBytes(const void* data, size_t size, unsigned long long hash)
+{
+	const unsigned char* bytes = (const unsigned char*)data;
+	for(size_t i=0; i<size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+//=========================================================//
+
+static unsigned long long getBakeKey(const vector<cVector3d>& vertices, int resolution, double bandWidth)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for(unsigned int i=0; i<vertices.size(); i++)
+	{
+		// single precision, so that rounding noise of the loader does not change the key
+		float position[3] = {(float)vertices[i].x, (float)vertices[i].y, (float)vertices[i].z};
+		hash = hashBytes(position, sizeof(position), hash);
+	}
+	hash = hashBytes(&resolution, sizeof(resolution), hash);
+	hash = hashBytes(&bandWidth, sizeof(bandWidth), hash);
+	return hash;
+}
+
+//=========================================================//
+
+// squared distance from a point to a triangle (Ericson, Real-Time Collision Detection, 5.1.5)
+static double getTriangleDistanceSq(const cVector3d& p, const cVector3d& a, const cVector3d& b, const cVector3d& c)
+{
+	cVector3d ab = b - a;
+	cVector3d ac = c - a;
+	cVector3d ap = p - a;
+	double d1 = ab.dot(ap);
+	double d2 = ac.dot(ap);
+	if(d1 <= 0 && d2 <= 0)
+		return ap.lengthsq();
+
+	cVector3d bp = p - b;
+	double d3 = ab.dot(bp);
+	double d4 = ac.dot(bp);
+	if(d3 >= 0 && d4 <= d3)
+		return bp.lengthsq();
+
+	double vc = d1*d4 - d3*d2;
+	if(vc <= 0 && d1 >= 0 && d3 <= 0)
+		return (ap - ab * (d1 / (d1 - d3))).lengthsq();
+
+	cVector3d cp = p - c;
+	double d5 = ab.dot(cp);
+	double d6 = ac.dot(cp);
+	if(d6 >= 0 && d5 <= d6)
+		return cp.lengthsq();
+
+	double vb = d5*d2 - d1*d6;
+	if(vb <= 0 && d2 >= 0 && d6 <= 0)
+		return (ap - ac * (d2 / (d2 - d6))).lengthsq();
+
+	double va = d3*d6 - d5*d4;
+	if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0)
+		return (bp - (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)))).lengthsq();
+
+	double denominator = 1.0 / (va + vb + vc);
+	return (ap - ab * (vb * denominator) - ac * (vc * denominator)).lengthsq();
+}
+
+//=========================================================//
+
+static void computeBrickDistances(int begin, int end, void* arg)
+{
+	SDFBakeJob& job = *(SDFBakeJob*)arg;
+	const vector<cVector3d>& vertices = *job.vertices;
+	double bandSq = job.bandWidth * job.bandWidth;
+
+	for(int place=begin; place<end; place++)
+	{
+		int brick	= job.poolBricks[place];
+		int bx		= brick % job.bricksX;
+		int by		= (brick / job.bricksX) % job.bricksY;
+		int bz		= brick / (job.bricksX * job.bricksY);
+		int first	= job.brickOffsets[brick];
+		int last	= job.brickOffsets[brick + 1];
+		float* samples = job.brickPool + place * SDF_BRICK_STRIDE;
+
+		for(int z=0; z<SDF_BRICK_SAMPLES; z++)
+		for(int y=0; y<SDF_BRICK_SAMPLES; y++)
+		for(int x=0; x<SDF_BRICK_SAMPLES; x++)
+		{
+			cVector3d position = job.origin + cVector3d(bx * SDF_BRICK_SIZE + x,
+				by * SDF_BRICK_SIZE + y, bz * SDF_BRICK_SIZE + z) * job.voxelSize;
+
+			double distanceSq = bandSq;
+			for(int i=first; i<last; i++)
+			{
+				// the bounding box of the triangle is cheaper and rules most of them out
+				int t = job.brickTriangles[i];
+				cVector3d outside = getMaxVector(getMaxVector(job.bounds[2*t] - position, position - job.bounds[2*t+1]), cVector3d(0,0,0));
+				if(outside.lengthsq() >= distanceSq)
+					continue;
+
+				double triangleSq = getTriangleDistanceSq(position, vertices[3*t], vertices[3*t+1], vertices[3*t+2]);
+				if(triangleSq < distanceSq)
+					distanceSq = triangleSq;
+			}
+
+			samples[x + SDF_BRICK_SAMPLES * (y + SDF_BRICK_SAMPLES * z)] = (float)sqrt(distanceSq);
+		}
+	}
+}
+
+//=========================================================//
+
+static void computeRowSigns(int begin, int end, void* arg)
+{
+	SDFBakeJob& job = *(SDFBakeJob*)arg;
+	const vector<cVector3d>& vertices = *job.vertices;
+	int				sizeY = job.bricksY * SDF_BRICK_SIZE + 1;
+	vector<int>		triangles;
+	vector<double>	crossings;
+	vector<char>	isInside(job.sizeX);
+
+	for(int row=begin; row<end; row++)
+	{
+		int y = row % sizeY;
+		int z = row / sizeY;
+
+		// a ray along x through the samples of the row, nudged off the edges shared by triangles
+		double rayY = job.origin.y + (y + 1.3e-4) * job.voxelSize;
+		double rayZ = job.origin.z + (z + 0.7e-4) * job.voxelSize;
+
+		// every triangle the ray crosses inside the grid is listed in a brick of the row
+		triangles.clear();
+		int rowBrickY = cMin(y / SDF_BRICK_SIZE, job.bricksY - 1);
+		int rowBrickZ = cMin(z / SDF_BRICK_SIZE, job.bricksZ - 1);
+		for(int bx=0; bx<job.bricksX; bx++)
+		{
+			int brick = bx + job.bricksX * (rowBrickY + job.bricksY * rowBrickZ);
+			triangles.insert(triangles.end(),
+				job.brickTriangles.begin() + job.brickOffsets[brick],
+				job.brickTriangles.begin() + job.brickOffsets[brick + 1]);
+		}
+		sort(triangles.begin(), triangles.end());
+		triangles.erase(unique(triangles.begin(), triangles.end()), triangles.end());
+
+		crossings.clear();
+		for(unsigned int i=0; i<triangles.size(); i++)
+		{
+			const cVector3d& a = vertices[3 * triangles[i]];
+			const cVector3d& b = vertices[3 * triangles[i] + 1];
+			const cVector3d& c = vertices[3 * triangles[i] + 2];
+
+			// edge functions of the triangle projected on the y-z plane
+			double eab = (b.y - a.y) * (rayZ - a.z) - (b.z - a.z) * (rayY - a.y);
+			double ebc = (c.y - b.y) * (rayZ - b.z) - (c.z - b.z) * (rayY - b.y);
+			double eca = (a.y - c.y) * (rayZ - c.z) - (a.z - c.z) * (rayY - c.y);
+
+			bool isCrossed = (eab > 0 && ebc > 0 && eca > 0) || (eab < 0 && ebc < 0 && eca < 0);
+			if(!isCrossed)
+				continue;
+
+			double sum = eab + ebc + eca;
+			crossings.push_back((ebc * a.x + eca * b.x + eab * c.x) / sum);
+		}
+		sort(crossings.begin(), crossings.end());
+
+		// a sample is inside after an odd number of crossings
+		unsigned int numCrossed = 0;
+		for(int x=0; x<job.sizeX; x++)
+		{
+			double sampleX = job.origin.x + x * job.voxelSize;
+			while(numCrossed < crossings.size() && crossings[numCrossed] < sampleX)
+				numCrossed++;
+			isInside[x] = (numCrossed % 2 == 1);
+		}
+
+		// the row is in the bricks of its index, and repeated as the last samples of the
+		// bricks before when it starts a brick
+		for(int j=0; j<2; j++)
+		for(int k=0; k<2; k++)
+		{
+			int by = y / SDF_BRICK_SIZE - j;
+			int bz = z / SDF_BRICK_SIZE - k;
+			int ly = y - by * SDF_BRICK_SIZE;
+			int lz = z - bz * SDF_BRICK_SIZE;
+			if(by < 0 || bz < 0 || by >= job.bricksY || bz >= job.bricksZ || ly > SDF_BRICK_SIZE || lz > SDF_BRICK_SIZE)
+				continue;
+
+			for(int bx=0; bx<job.bricksX; bx++)
+			{
+				int brick = bx + job.bricksX * (by + job.bricksY * bz);
+				int entry = job.brickTable[brick];
+				if(entry >= 0)
+				{
+					float* samples = job.brickPool + entry * SDF_BRICK_STRIDE + SDF_BRICK_SAMPLES * (ly + SDF_BRICK_SAMPLES * lz);
+					for(int lx=0; lx<SDF_BRICK_SAMPLES; lx++)
+						if(isInside[bx * SDF_BRICK_SIZE + lx])
+							samples[lx] = -samples[lx];
+				}
+				// a brick away from the surface is all on the side of its first sample
+				else if(ly == 0 && lz == 0)
+					job.isFarInside[brick] = isInside[bx * SDF_BRICK_SIZE];
+			}
+		}
+	}
+}
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+SignedDistanceField::SignedDistanceField(void)
+{
+	bricksX			= 0;
+	bricksY			= 0;
+	bricksZ			= 0;
+	voxelSize		= 0;
+	bandWidth		= 0;
+	brickPool		= NULL;
+	numPoolBricks	= 0;
+	origin.zero();
+}
+
+//=========================================================//
+
+SignedDistanceField::~SignedDistanceField(void)
+{
+	allocatePool(0);
+}
+
+//=========================================================//
+
+void SignedDistanceField::allocatePool(int numBricks)
+{
+	if(brickPool != NULL)
+	{
+#if defined(_WIN32)
+		_aligned_free(brickPool);
+#else
+		free(brickPool);
+#endif
+		brickPool = NULL;
+	}
+
+	numPoolBricks = numBricks;
+	if(numBricks == 0)
+		return;
+
+	size_t size = (size_t)numBricks * SDF_BRICK_STRIDE * sizeof(float);
+#if defined(_WIN32)
+	brickPool = (float*)_aligned_malloc(size, SDF_CACHE_LINE);
+#else
+	void* pool = NULL;
+	if(posix_memalign(&pool, SDF_CACHE_LINE, size) == 0)
+		brickPool = (float*)pool;
+#endif
+	if(brickPool == NULL)
+		numPoolBricks = 0;
+}
+
+//=========================================================//
+
+bool SignedDistanceField::bake(cMesh* mesh, int resolution, double bandWidth)
+{
+	vector<cVector3d> vertices;
+	collectTriangles(mesh, cIdentity3d(), cVector3d(0,0,0), vertices);
+
+	return bakeTriangles(vertices, resolution, bandWidth);
+}
+
+//=========================================================//
+
+bool SignedDistanceField::bakeCached(cMesh* mesh, int resolution, double bandWidth, string cacheFileName)
+{
+	vector<cVector3d> vertices;
+	collectTriangles(mesh, cIdentity3d(), cVector3d(0,0,0), vertices);
+
+	unsigned long long key = getBakeKey(vertices, resolution, bandWidth);
+	if(loadFromFile(cacheFileName, key))
+		return true;
+
+	if(!bakeTriangles(vertices, resolution, bandWidth))
+		return false;
+
+	if(!saveToFile(cacheFileName, key))
+		printf("Warning - the distance field could not be cached in [%s].\n", cacheFileName.c_str());
+
+	return true;
+}
+
+//=========================================================//
+
+bool SignedDistanceField::loadCached(cMesh* mesh, int resolution, double bandWidth, string cacheFileName)
+{
+	vector<cVector3d> vertices;
+	collectTriangles(mesh, cIdentity3d(), cVector3d(0,0,0), vertices);
+
+	return loadFromFile(cacheFileName, getBakeKey(vertices, resolution, bandWidth));
+}
+
+//=========================================================//
+
+bool SignedDistanceField::bakeTriangles(const vector<cVector3d>& vertices, int resolution, double bandWidth)
+{
+	brickTable.clear();
+	allocatePool(0);
+	bricksX = bricksY = bricksZ = 0;
+
+	int numTriangles = vertices.size() / 3;
+	if(numTriangles == 0 || resolution < 1 || bandWidth <= 0)
+		return false;
+
+	// the grid covers the model and the band around it
+	cVector3d boundaryMin = vertices[0];
+	cVector3d boundaryMax = vertices[0];
+	for(unsigned int i=1; i<vertices.size(); i++)
+	{
+		boundaryMin.x = cMin(boundaryMin.x, vertices[i].x);
+		boundaryMin.y = cMin(boundaryMin.y, vertices[i].y);
+		boundaryMin.z = cMin(boundaryMin.z, vertices[i].z);
+		boundaryMax.x = cMax(boundaryMax.x, vertices[i].x);
+		boundaryMax.y = cMax(boundaryMax.y, vertices[i].y);
+		boundaryMax.z = cMax(boundaryMax.z, vertices[i].z);
+	}
+
+	cVector3d extent = boundaryMax - boundaryMin;
+	double longestSide = cMax(extent.x, cMax(extent.y, extent.z));
+	if(longestSide <= 0)
+		return false;
+
+	this->bandWidth	= bandWidth;
+	voxelSize		= longestSide / resolution;
+	origin			= boundaryMin - cVector3d(bandWidth, bandWidth, bandWidth);
+	double brickSide = SDF_BRICK_SIZE * voxelSize;
+	bricksX			= (int)ceil((extent.x + 2 * bandWidth) / brickSide);
+	bricksY			= (int)ceil((extent.y + 2 * bandWidth) / brickSide);
+	bricksZ			= (int)ceil((extent.z + 2 * bandWidth) / brickSide);
+	int numBricks	= bricksX * bricksY * bricksZ;
+
+	SDFBakeJob job;
+	job.vertices	= &vertices;
+	job.origin		= origin;
+	job.voxelSize	= voxelSize;
+	job.bandWidth	= bandWidth;
+	job.bricksX		= bricksX;
+	job.bricksY		= bricksY;
+	job.bricksZ		= bricksZ;
+	job.sizeX		= bricksX * SDF_BRICK_SIZE + 1;
+
+	// bricks -> triangles within the band of their samples, the repeated ones included;
+	// the bricks with none are away from the surface and get no samples
+	vector<int> brickRanges(6 * numTriangles);
+	job.brickOffsets.assign(numBricks + 1, 0);
+	job.bounds.resize(2 * numTriangles);
+	for(int t=0; t<numTriangles; t++)
+	{
+		const cVector3d& a = vertices[3*t];
+		const cVector3d& b = vertices[3*t+1];
+		const cVector3d& c = vertices[3*t+2];
+		int* range = &brickRanges[6*t];
+
+		double low[3]	= {cMin(a.x, cMin(b.x, c.x)), cMin(a.y, cMin(b.y, c.y)), cMin(a.z, cMin(b.z, c.z))};
+		double high[3]	= {cMax(a.x, cMax(b.x, c.x)), cMax(a.y, cMax(b.y, c.y)), cMax(a.z, cMax(b.z, c.z))};
+		job.bounds[2*t].set(low[0], low[1], low[2]);
+		job.bounds[2*t+1].set(high[0], high[1], high[2]);
+		double start[3]	= {origin.x, origin.y, origin.z};
+		int numAxisBricks[3] = {bricksX, bricksY, bricksZ};
+		for(int axis=0; axis<3; axis++)
+		{
+			range[axis]		= (int)ceil((low[axis] - bandWidth - start[axis]) / brickSide) - 1;
+			range[axis + 3]	= (int)floor((high[axis] + bandWidth - start[axis]) / brickSide);
+			range[axis]		= cClamp(range[axis], 0, numAxisBricks[axis] - 1);
+			range[axis + 3]	= cClamp(range[axis + 3], 0, numAxisBricks[axis] - 1);
+		}
+
+		for(int bz=range[2]; bz<=range[5]; bz++)
+		for(int by=range[1]; by<=range[4]; by++)
+		for(int bx=range[0]; bx<=range[3]; bx++)
+			job.brickOffsets[bx + bricksX * (by + bricksY * bz) + 1]++;
+	}
+
+	brickTable.assign(numBricks, SDF_FAR_OUTSIDE);
+	for(int brick=0; brick<numBricks; brick++)
+	{
+		if(job.brickOffsets[brick + 1] > 0)
+		{
+			brickTable[brick] = job.poolBricks.size();
+			job.poolBricks.push_back(brick);
+		}
+		job.brickOffsets[brick + 1] += job.brickOffsets[brick];
+	}
+
+	job.brickTriangles.resize(job.brickOffsets[numBricks]);
+	vector<int> fill(job.brickOffsets.begin(), job.brickOffsets.end() - 1);
+	for(int t=0; t<numTriangles; t++)
+	{
+		int* range = &brickRanges[6*t];
+		for(int bz=range[2]; bz<=range[5]; bz++)
+		for(int by=range[1]; by<=range[4]; by++)
+		for(int bx=range[0]; bx<=range[3]; bx++)
+			job.brickTriangles[fill[bx + bricksX * (by + bricksY * bz)]++] = t;
+	}
+
+	allocatePool(job.poolBricks.size());
+	if(numPoolBricks != (int)job.poolBricks.size())
+	{
+		brickTable.clear();
+		return false;
+	}
+	job.brickTable	= &brickTable[0];
+	job.brickPool	= brickPool;
+	job.isFarInside.assign(numBricks, 0);
+
+	// pass 1: unsigned distances, one brick per task
+	WorkerPool::getInstance()->parallelFor(numPoolBricks, computeBrickDistances, &job);
+
+	// pass 2: inside or outside, by counting the crossings of the surface along each row
+	int numRows = (bricksY * SDF_BRICK_SIZE + 1) * (bricksZ * SDF_BRICK_SIZE + 1);
+	WorkerPool::getInstance()->parallelFor(numRows, computeRowSigns, &job);
+
+	for(int brick=0; brick<numBricks; brick++)
+		if(brickTable[brick] < 0 && job.isFarInside[brick])
+			brickTable[brick] = SDF_FAR_INSIDE;
+
+	return true;
+}
+
+//=========================================================//
+
+bool SignedDistanceField::getDistance(const cVector3d& position, double& distance, cVector3d& gradient)
+{
+	if(brickTable.empty())
+		return false;
+
+	double gx = (position.x - origin.x) / voxelSize;
+	double gy = (position.y - origin.y) / voxelSize;
+	double gz = (position.z - origin.z) / voxelSize;
+	if(gx < 0 || gy < 0 || gz < 0 ||
+		gx > bricksX * SDF_BRICK_SIZE || gy > bricksY * SDF_BRICK_SIZE || gz > bricksZ * SDF_BRICK_SIZE)
+		return false;
+
+	int x = cMin((int)gx, bricksX * SDF_BRICK_SIZE - 1);
+	int y = cMin((int)gy, bricksY * SDF_BRICK_SIZE - 1);
+	int z = cMin((int)gz, bricksZ * SDF_BRICK_SIZE - 1);
+	double fx = gx - x;
+	double fy = gy - y;
+	double fz = gz - z;
+
+	// first indirection: the brick
+	int entry = brickTable[x / SDF_BRICK_SIZE + bricksX * (y / SDF_BRICK_SIZE + bricksY * (z / SDF_BRICK_SIZE))];
+	if(entry < 0)
+	{
+		distance = (entry == SDF_FAR_INSIDE) ? -bandWidth : bandWidth;
+		gradient.zero();
+		return true;
+	}
+
+	// second indirection: the eight samples around the position, all in the brick
+	const float* corner	= brickPool + entry * SDF_BRICK_STRIDE + (x % SDF_BRICK_SIZE) +
+		SDF_BRICK_SAMPLES * ((y % SDF_BRICK_SIZE) + SDF_BRICK_SAMPLES * (z % SDF_BRICK_SIZE));
+	const int stepY		= SDF_BRICK_SAMPLES;
+	const int stepZ		= SDF_BRICK_SAMPLES * SDF_BRICK_SAMPLES;
+	double d000 = corner[0];
+	double d100 = corner[1];
+	double d010 = corner[stepY];
+	double d110 = corner[stepY + 1];
+	double d001 = corner[stepZ];
+	double d101 = corner[stepZ + 1];
+	double d011 = corner[stepZ + stepY];
+	double d111 = corner[stepZ + stepY + 1];
+
+	// interpolated along x, then y, then z
+	double d00 = d000 + (d100 - d000) * fx;
+	double d10 = d010 + (d110 - d010) * fx;
+	double d01 = d001 + (d101 - d001) * fx;
+	double d11 = d011 + (d111 - d011) * fx;
+	double d0 = d00 + (d10 - d00) * fy;
+	double d1 = d01 + (d11 - d01) * fy;
+	distance = d0 + (d1 - d0) * fz;
+
+	// the derivatives of the same interpolation
+	double dx00 = d100 - d000;
+	double dx10 = d110 - d010;
+	double dx01 = d101 - d001;
+	double dx11 = d111 - d011;
+	double dx0 = dx00 + (dx10 - dx00) * fy;
+	double dx1 = dx01 + (dx11 - dx01) * fy;
+	gradient.x = (dx0 + (dx1 - dx0) * fz) / voxelSize;
+	gradient.y = ((d10 - d00) + ((d11 - d01) - (d10 - d00)) * fz) / voxelSize;
+	gradient.z = (d1 - d0) / voxelSize;
+
+	return true;
+}
+
+//=========================================================//
+
+bool SignedDistanceField::loadFromFile(string fileName, unsigned long long key)
+{
+	FILE* file = fopen(fileName.c_str(), "rb");
+	if(file == NULL)
+		return false;
+
+	char				tag[8];
+	unsigned long long	fileKey;
+	int					size[4];		// bricks along each axis, bricks in the pool
+	double				header[5];		// origin, voxel size, band width
+	bool isValid =
+		fread(tag, sizeof(tag), 1, file) == 1 && memcmp(tag, SDF_FILE_TAG, sizeof(tag)) == 0 &&
+		fread(&fileKey, sizeof(fileKey), 1, file) == 1 && fileKey == key &&
+		fread(size, sizeof(size), 1, file) == 1 && size[0] > 0 && size[1] > 0 && size[2] > 0 && size[3] >= 0 &&
+		fread(header, sizeof(header), 1, file) == 1;
+
+	if(isValid)
+	{
+		brickTable.resize(size[0] * size[1] * size[2]);
+		allocatePool(size[3]);
+		isValid = numPoolBricks == size[3] &&
+			fread(&brickTable[0], sizeof(int), brickTable.size(), file) == brickTable.size() &&
+			fread(brickPool, sizeof(float) * SDF_BRICK_STRIDE, numPoolBricks, file) == (size_t)numPoolBricks;
+	}
+	fclose(file);
+
+	if(!isValid)
+	{
+		brickTable.clear();
+		allocatePool(0);
+		return false;
+	}
+
+	bricksX		= size[0];
+	bricksY		= size[1];
+	bricksZ		= size[2];
+	origin.set(header[0], header[1], header[2]);
+	voxelSize	= header[3];
+	bandWidth	= header[4];
+	return true;
+}
+
+//=========================================================//
+
+bool SignedDistanceField::saveToFile(string fileName, unsigned long long key)
+{
+	// written aside and renamed, so that an interrupted write never leaves a valid-looking file
+	string partialFileName = fileName + ".part";
+	FILE* file = fopen(partialFileName.c_str(), "wb");
+	if(file == NULL)
+		return false;
+
+	int		size[4]		= {bricksX, bricksY, bricksZ, numPoolBricks};
+	double	header[5]	= {origin.x, origin.y, origin.z, voxelSize, bandWidth};
+	bool isWritten =
+		fwrite(SDF_FILE_TAG, sizeof(SDF_FILE_TAG), 1, file) == 1 &&
+		fwrite(&key, sizeof(key), 1, file) == 1 &&
+		fwrite(size, sizeof(size), 1, file) == 1 &&
+		fwrite(header, sizeof(header), 1, file) == 1 &&
+		fwrite(&brickTable[0], sizeof(int), brickTable.size(), file) == brickTable.size() &&
+		fwrite(brickPool, sizeof(float) * SDF_BRICK_STRIDE, numPoolBricks, file) == (size_t)numPoolBricks;
+	isWritten = (fclose(file) == 0) && isWritten;
+
+	remove(fileName.c_str());
+	if(!isWritten || rename(partialFileName.c_str(), fileName.c_str()) != 0)
+	{
+		remove(partialFileName.c_str());
+		return false;
+	}
+	return true;
+}
+
+//=========================================================//
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//==================SETTERS AND GETTERS====================//
+//=========================================================*/
+
+bool SignedDistanceField::isEmpty(void)
+{
+	return brickTable.empty();
+}
+
+//=========================================================//
+
+int SignedDistanceField::getNumBricks(void)
+{
+	return (int)brickTable.size();
+}
+
+//=========================================================//
+
+int SignedDistanceField::getNumPoolBricks(void)
+{
+	return numPoolBricks;
+}
+
+//=========================================================//
+
+long SignedDistanceField::getMemorySize(void)
+{
+	return (long)(brickTable.size() * sizeof(int)) + (long)numPoolBricks * SDF_BRICK_STRIDE * sizeof(float);
+}
+
+//=========================================================//
+
+double SignedDistanceField::getVoxelSize(void)
+{
+	return voxelSize;
+}
+
+//=========================================================//
+
+double SignedDistanceField::getBandWidth(void)
+{
+	return bandWidth;
+}
+
+//=========================================================//
@@ -0,0 +1,91 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Signed Distance Field]
+The signed distance from the surface of the anatomy model, sampled on a
+regular grid around it: negative inside the closed surface, positive outside.
+The haptic loop reads the distance and its gradient with one trilinear
+lookup, so a wall force costs the same whatever the number of triangles of
+the model. The distances are exact within a band around the surface and
+clamped beyond it.
+Only the band is stored: the grid is split in bricks of 8x8x8 voxels, and
+only the bricks the surface passes near get samples, kept in one pool
+aligned on cache lines. A lookup reads the brick table, then the samples of
+one brick, so memory grows with the area of the surface and not with the
+volume around it.
+The grid is baked on all the cores (see WorkerPool) and saved to a cache
+file, which is read back as long as the model and the settings are the same.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class SignedDistanceField
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	int				bricksX;			// bricks along each axis
+	int				bricksY;
+	int				bricksZ;
+	cVector3d		origin;				// position of sample (0,0,0), in the frame of the model
+	double			voxelSize;
+	double			bandWidth;			// the distances are exact up to here and clamped beyond
+	vector<int>		brickTable;			// per brick, its place in the pool, or far inside/outside
+	float*			brickPool;			// the samples of the bricks near the surface
+	int				numPoolBricks;
+
+	//========================[METHODS]========================//
+	// not copyable, the pool is owned
+	SignedDistanceField(const SignedDistanceField&);
+	SignedDistanceField& operator=(const SignedDistanceField&);
+
+	// replaces the pool by an uninitialized one of the given number of bricks
+	void		allocatePool(int numBricks);
+	// bakes the field of a triangle soup, three vertices per triangle
+	bool		bakeTriangles(const vector<cVector3d>& vertices, int resolution, double bandWidth);
+	// reads the field from a cache file; false if it is missing or was baked from something else
+	bool		loadFromFile(string fileName, unsigned long long key);
+	bool		saveToFile(string fileName, unsigned long long key);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; an empty field reports no distance
+	SignedDistanceField(void);
+	// destructor
+	~SignedDistanceField(void);
+	// samples the distance from the triangles of the mesh and of its child meshes;
+	// resolution is the number of voxels along the longest side of the model
+	bool		bake(cMesh* mesh, int resolution, double bandWidth);
+	// as bake, but reads the field from the cache file if it was baked from the same
+	// triangles and settings, and writes it there otherwise
+	bool		bakeCached(cMesh* mesh, int resolution, double bandWidth, string cacheFileName);
+	// only reads the cache file; false if it holds no field of the same triangles and settings
+	bool		loadCached(cMesh* mesh, int resolution, double bandWidth, string cacheFileName);
+	// trilinear distance and gradient at a position of the frame of the model;
+	// returns false outside the grid. Far from the surface the gradient is zero
+	bool		getDistance(const cVector3d& position, double& distance, cVector3d& gradient);
+
+	//========================[METHODS]===setters & getters====//
+	bool		isEmpty(void);
+	int			getNumBricks(void);
+	// bricks near the surface, the only ones holding samples
+	int			getNumPoolBricks(void);
+	// bytes used by the brick table and the pool
+	long		getMemorySize(void);
+	double		getVoxelSize(void);
+	double		getBandWidth(void);
+};
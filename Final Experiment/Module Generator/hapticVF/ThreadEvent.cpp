@@ -0,0 +1,88 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Thread Event]
+A manual-reset event: threads calling wait() sleep until another thread calls
+set(), instead of spinning on a flag.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+ThreadEvent::ThreadEvent(void)
+{
+#if defined(_WIN32)
+	handle = CreateEvent(NULL, TRUE, FALSE, NULL);
+#else
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&condition, NULL);
+	isSignaled = false;
+#endif
+}
+
+//=========================================================//
+
+ThreadEvent::~ThreadEvent(void)
+{
+#if defined(_WIN32)
+	CloseHandle(handle);
+#else
+	pthread_cond_destroy(&condition);
+	pthread_mutex_destroy(&mutex);
+#endif
+}
+
+//=========================================================//
+
+void ThreadEvent::set(void)
+{
+#if defined(_WIN32)
+	SetEvent(handle);
+#else
+	pthread_mutex_lock(&mutex);
+	isSignaled = true;
+	pthread_cond_broadcast(&condition);
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+//=========================================================//
+
+void ThreadEvent::reset(void)
+{
+#if defined(_WIN32)
+	ResetEvent(handle);
+#else
+	pthread_mutex_lock(&mutex);
+	isSignaled = false;
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+//=========================================================//
+
+void ThreadEvent::wait(void)
+{
+#if defined(_WIN32)
+	WaitForSingleObject(handle, INFINITE);
+#else
+	pthread_mutex_lock(&mutex);
+	while(!isSignaled)
+		pthread_cond_wait(&condition, &mutex);
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+//=========================================================//
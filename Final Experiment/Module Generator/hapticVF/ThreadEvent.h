@@ -0,0 +1,54 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Thread Event]
+A manual-reset event: threads calling wait() sleep until another thread calls
+set(), instead of spinning on a flag.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class ThreadEvent
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+#if defined(_WIN32)
+	HANDLE				handle;
+#else
+	pthread_mutex_t		mutex;
+	pthread_cond_t		condition;
+	bool				isSignaled;
+#endif
+
+	// not copyable
+	ThreadEvent(const ThreadEvent&);
+	ThreadEvent& operator=(const ThreadEvent&);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; the event starts cleared
+	ThreadEvent(void);
+	// destructor
+	~ThreadEvent(void);
+	// signals the event and wakes every waiting thread
+	void		set(void);
+	// clears the event
+	void		reset(void);
+	// blocks until the event is signaled
+	void		wait(void);
+};
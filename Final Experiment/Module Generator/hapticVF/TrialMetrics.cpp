@@ -0,0 +1,186 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Trial Metrics]
+The measurements of the trials of a module: completion time and collisions
+of every trial, and the split of each trial into the segments of the path
+with their dwell time, collisions and peak force. The timestamps are taken
+by the haptic loop when the events happen (see MonotonicClock) and the
+records are kept by the session service, for any number of trials.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+double SegmentRecord::getDwellTime(void)
+{
+	if(exitedTime == 0)
+		return 0;
+
+	return nanosecondsToSeconds(exitedTime - enteredTime);
+}
+
+//=========================================================//
+
+double TrialRecord::getTotalTime(void)
+{
+	return nanosecondsToSeconds(endingTime - startingTime);
+}
+
+//=========================================================//
+
+TrialMetrics::TrialMetrics(void)
+{
+	reset();
+}
+
+//=========================================================//
+
+void TrialMetrics::reset(void)
+{
+	trials.clear();
+	isTrialRunning	= false;
+	currentSegment	= -1;
+}
+
+//=========================================================//
+
+void TrialMetrics::startTrial(long long time)
+{
+	currentTrial.startingTime		= time;
+	currentTrial.endingTime			= time;
+	currentTrial.numOfCollisions	= 0;
+	currentTrial.segments.clear();
+
+	isTrialRunning	= true;
+	currentSegment	= -1;
+}
+
+//=========================================================//
+
+void TrialMetrics::endTrial(long long time)
+{
+	if(!isTrialRunning)
+		return;
+
+	currentTrial.endingTime = time;
+	trials.push_back(currentTrial);
+
+	isTrialRunning	= false;
+	currentSegment	= -1;
+}
+
+//=========================================================//
+
+void TrialMetrics::enterSegment(int segment, long long time)
+{
+	// the segments before the trial starts are not measured
+	if(!isTrialRunning)
+		return;
+
+	SegmentRecord record;
+	record.segment			= segment;
+	record.enteredTime		= time;
+	record.exitedTime		= 0;
+	record.numOfCollisions	= 0;
+	record.peakForce		= 0;
+
+	currentTrial.segments.push_back(record);
+	currentSegment = (int)currentTrial.segments.size() - 1;
+}
+
+//=========================================================//
+
+void TrialMetrics::exitSegment(int segment, long long time, double peakForce)
+{
+	if(currentSegment < 0 || currentTrial.segments[currentSegment].segment != segment)
+		return;
+
+	currentTrial.segments[currentSegment].exitedTime	= time;
+	currentTrial.segments[currentSegment].peakForce		= peakForce;
+	currentSegment = -1;
+}
+
+//=========================================================//
+
+void TrialMetrics::addCollision(void)
+{
+	if(!isTrialRunning)
+		return;
+
+	currentTrial.numOfCollisions++;
+	if(currentSegment >= 0)
+		currentTrial.segments[currentSegment].numOfCollisions++;
+}
+
+//=========================================================//
+
+int TrialMetrics::getNumTrials(void)
+{
+	return (int)trials.size();
+}
+
+//=========================================================//
+
+TrialRecord TrialMetrics::getTrial(int index)
+{
+	return trials[index];
+}
+
+//=========================================================//
+
+double TrialMetrics::getAverageTime(void)
+{
+	if(trials.empty())
+		return 0;
+
+	double sum = 0;
+	for(unsigned int i=0; i<trials.size(); i++)
+		sum += trials[i].getTotalTime();
+
+	return sum / trials.size();
+}
+
+//=========================================================//
+
+double TrialMetrics::getAverageNumCollisions(void)
+{
+	if(trials.empty())
+		return 0;
+
+	double sum = 0;
+	for(unsigned int i=0; i<trials.size(); i++)
+		sum += trials[i].numOfCollisions;
+
+	return sum / trials.size();
+}
+
+//=========================================================//
+
+void TrialMetrics::writeSegments(ostream& output)
+{
+	output<<"Trial Segment Dwell[s] Collisions PeakForce[N]"<<endl;
+	for(unsigned int i=0; i<trials.size(); i++)
+	{
+		for(unsigned int j=0; j<trials[i].segments.size(); j++)
+		{
+			SegmentRecord& record = trials[i].segments[j];
+			output<<(i + 1)<<" "<<record.segment<<" "<<fixed<<setprecision(6)<<record.getDwellTime()<<" ";
+			output<<record.numOfCollisions<<" "<<setprecision(4)<<record.peakForce<<endl;
+		}
+	}
+}
+
+//=========================================================//
@@ -0,0 +1,84 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Trial Metrics]
+The measurements of the trials of a module: completion time and collisions
+of every trial, and the split of each trial into the segments of the path
+with their dwell time, collisions and peak force. The timestamps are taken
+by the haptic loop when the events happen (see MonotonicClock) and the
+records are kept by the session service, for any number of trials.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+typedef struct SegmentRecord{
+
+public:
+	int			segment;			// index of the line in its fixture set
+	long long	enteredTime;		// [ns]
+	long long	exitedTime;			// [ns], 0 while the tool is inside
+	int			numOfCollisions;
+	double		peakForce;			// [N]
+
+	double		getDwellTime(void);	// [s]
+
+};
+
+typedef struct TrialRecord{
+
+public:
+	long long				startingTime;	// [ns]
+	long long				endingTime;		// [ns]
+	int						numOfCollisions;
+	vector<SegmentRecord>	segments;		// in the order they were entered
+
+	double		getTotalTime(void);	// [s]
+
+};
+
+class TrialMetrics
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	vector<TrialRecord>		trials;			// completed trials
+	TrialRecord				currentTrial;
+	bool					isTrialRunning;
+	int						currentSegment;	// index in currentTrial.segments, -1 outside
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor
+	TrialMetrics(void);
+	// forgets every trial, including the running one
+	void		reset(void);
+
+	void		startTrial(long long time);
+	void		endTrial(long long time);
+	void		enterSegment(int segment, long long time);
+	void		exitSegment(int segment, long long time, double peakForce);
+	// counted for the running trial and the segment the tool is in
+	void		addCollision(void);
+
+	//========================[METHODS]========================//
+	int			getNumTrials(void);
+	TrialRecord	getTrial(int index);
+	double		getAverageTime(void);
+	double		getAverageNumCollisions(void);
+	// writes one row per segment of every trial
+	void		writeSegments(ostream& output);
+};
@@ -18,17 +18,45 @@ Qatar University
 
 #include "stdafx.h"
 
+map<string, cMesh*> VFBlock::prototypeMeshes;
+
 /*=========================================================//
 //==================[METHODS DEFINITIONS]==================//
 //=========================================================*/
 
 VFBlock::VFBlock()
+{
+	initialize(true);
+}
+
+//=========================================================//
+
+VFBlock::VFBlock(bool isImported)
+{
+	initialize(isImported);
+}
+
+//=========================================================//
+
+void VFBlock::initialize(bool isImported)
 {
 	values = CommonValues::getInstance();
 
 	values->defaultTransparencyLevel = 0.7;
 	isHidden = false;
 	isGhost = false;	
+	meshScale.set(1,1,1);
+	collisionName = "block";
+	collisionFlag = false;
+	isCorner = false;
+
+	if(!isImported)
+	{
+		cylinder	= NULL;
+		top			= NULL;
+		bottom		= NULL;
+		return;
+	}
 
 	importMeshes();
 	setupInitialMeshesProperties();
@@ -37,66 +65,88 @@ VFBlock::VFBlock()
 		
 	scale(values->BLOCK_SCALE_FACTOR);
 
-	collisionFlag = false;
-	isCorner = false;
-
 }
 
 //=========================================================//
 
 void VFBlock::importMeshes(void)
 {
-	string modelPath_body = "../resources/cylinder.3DS";
-	string modelPath_top = "../resources/top.3DS";
-	string modelPath_bottom = "../resources/bottom.3DS";
+	cylinder	= createMeshFromFile("../resources/cylinder.3DS", "body");
+	top			= createMeshFromFile("../resources/top.3DS", "top");
+	bottom		= createMeshFromFile("../resources/bottom.3DS", "bottom");
 
-	bool fileload;
-	string resourceRoot;
+	// add to the collision node of the fixtures (attached to the collision scene once the path
+	// is built)
+	values->fixtureCollisionRoot->addChild(cylinder);
+	values->fixtureCollisionRoot->addChild(top);
+	values->fixtureCollisionRoot->addChild(bottom);
+}
 
-	cylinder = new cMesh(values->world);
+//=========================================================//
 
-	fileload = cylinder->loadFromFile(RESOURCE_PATH(modelPath_body));
-	if (!fileload)
-	{
-		#if defined(_MSVC)
-		fileload = cylinder->loadFromFile(modelPath_body);
-		#endif
-	}
-	if (!fileload)
+cMesh* VFBlock::createMeshFromFile(string modelPath, string partName)
+{
+	cMesh*& prototype = prototypeMeshes[modelPath];
+	if(prototype == NULL)
 	{
-		printf("Error - 3D Model [body] failed to load correctly.\n");
+		bool fileload;
+		string resourceRoot;
+
+		prototype = new cMesh(values->world);
+
+		fileload = prototype->loadFromFile(RESOURCE_PATH(modelPath));
+		if (!fileload)
+		{
+			#if defined(_MSVC)
+			fileload = prototype->loadFromFile(modelPath);
+			#endif
+		}
+		if (!fileload)
+		{
+			printf("Error - 3D Model [%s] failed to load correctly.\n", partName.c_str());
+		}
 	}
 
-	//===================================================
+	cMesh* mesh = new cMesh(values->world);
+	copyMesh(prototype, mesh);
 
-	top = new cMesh(values->world);
+	return mesh;
+}
 
-	fileload = top->loadFromFile(RESOURCE_PATH(modelPath_top));
-	if (!fileload)
+//=========================================================//
+
+void VFBlock::copyMesh(cMesh* source, cMesh* target)
+{
+	// the vertices keep their indices, so the triangles and the marks (see
+	// setupInitialMeshesProperties) are those of the file
+	vector<cVertex>* vertices = source->pVertices();
+	target->pVertices()->reserve(vertices->size());
+	for(unsigned int i=0; i<vertices->size(); i++)
 	{
-		#if defined(_MSVC)
-		fileload = top->loadFromFile(modelPath_top);
-		#endif
+		unsigned int index = target->newVertex((*vertices)[i].getPos());
+		(*target->pVertices())[index].setNormal((*vertices)[i].getNormal());
 	}
-	if (!fileload)
+
+	vector<cTriangle>* triangles = source->pTriangles();
+	target->pTriangles()->reserve(triangles->size());
+	for(unsigned int i=0; i<triangles->size(); i++)
 	{
-		printf("Error - 3D Model [top] failed to load correctly.\n");
+		cTriangle& triangle = (*triangles)[i];
+		if(triangle.m_allocated)
+			target->newTriangle(triangle.getIndexVertex0(), triangle.getIndexVertex1(), triangle.getIndexVertex2());
 	}
 
-	//===================================================
+	target->m_material = source->m_material;
 
-	bottom = new cMesh(values->world);
-
-	fileload = bottom->loadFromFile(RESOURCE_PATH(modelPath_bottom));
-	if (!fileload)
-	{
-		#if defined(_MSVC)
-		fileload = bottom->loadFromFile(modelPath_bottom);
-		#endif
-	}
-	if (!fileload)
+	for(unsigned int i=0; i<source->getNumChildren(); i++)
 	{
-		printf("Error - 3D Model [bottom] failed to load correctly.\n");
+		cMesh* child = dynamic_cast<cMesh*>(source->getChild(i));
+		if(child == NULL)
+			continue;
+
+		cMesh* copy = new cMesh(target->getParentWorld());
+		target->addChild(copy);
+		copyMesh(child, copy);
 	}
 }
 
@@ -121,12 +171,31 @@ void VFBlock::setupInitialMeshesProperties(void)
     cylinder->scale((2.0 * values->tool->getWorkspaceRadius() / size));
 	top->scale((2.0 * values->tool->getWorkspaceRadius() / size));
 	bottom->scale((2.0 * values->tool->getWorkspaceRadius() / size));
+	meshScale = meshScale * (2.0 * values->tool->getWorkspaceRadius() / size);
 
 	// compute collision detection algorithm
-	cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-	top->createAABBCollisionDetector(values->proxyRadius, true, false);
-	bottom->createAABBCollisionDetector(values->proxyRadius, true, false);
+	updateCollisionDetectors();
+
+	setupMeshesAppearance();
+
+	// mark the side of the top mesh (top side)
+	topSidePos = top->pVerticesNonEmpty()->at(1).getPos();
 
+	// mark the center of the top mesh (top center)
+	topCenterPos = top->pVerticesNonEmpty()->at(0).getPos();
+
+	// mark the center of the bottom mesh (bottom center)
+	bottomCenterPos = bottom->pVerticesNonEmpty()->at(0).getPos();
+
+	// mark the side of the bottom mesh (bottom side)
+	bottomSidePos = bottom->pVerticesNonEmpty()->at(1).getPos();
+
+}
+
+//=========================================================//
+
+void VFBlock::setupMeshesAppearance(void)
+{
 	// setup cylinder material
 	cylinderMaterial.setStiffness(values->cylinderStiffness);
 	cylinderMaterial.m_ambient.set(0.0,0.0,0.0,0);
@@ -142,45 +211,43 @@ void VFBlock::setupInitialMeshesProperties(void)
 	cylinder->setUseCulling(true,true);
 	top->setUseCulling(true, true);
 	bottom->setUseCulling(true, true);
+}
 
-	// add to world
-	values->world->addChild(cylinder);
-	values->world->addChild(top);
-	values->world->addChild(bottom);
+//=========================================================//
 
-	// mark the side of the top mesh (top side)
-	topSideSphere = new cShapeSphere(0.0001);
-	top->addChild(topSideSphere);
-	topSideSphere->setPos(top->pVerticesNonEmpty()->at(1).getPos());
-	topSideSphere->setMaterial(values->pinkBlank);
+void VFBlock::updateCollisionDetectors(void)
+{
+	updateCollisionDetector(cylinder, collisionName + " body");
+	updateCollisionDetector(top, collisionName + " top");
+	updateCollisionDetector(bottom, collisionName + " bottom");
+}
 
-	// mark the center of the top mesh (top center)
-	topCenterSphere = new cShapeSphere(0.0001);
-	top->addChild(topCenterSphere);
-	topCenterSphere->setPos(top->pVerticesNonEmpty()->at(0).getPos());
+//=========================================================//
 
-	// mark the center of the bottom mesh (bottom center)
-	bottomCenterSphere = new cShapeSphere(0.0001);
-	bottom->addChild(bottomCenterSphere);
-	bottomCenterSphere->setPos(bottom->pVerticesNonEmpty()->at(0).getPos());
+void VFBlock::updateCollisionDetector(cMesh* mesh, string prototypeName)
+{
+	MeshCollisionBVH::createSharedCollisionDetectors(mesh, prototypeName, meshScale, values->proxyRadius);
+}
 
-	// mark the side of the bottom mesh (bottom side)
-	bottomSideSphere = new cShapeSphere(0.0001);
-	bottom->addChild(bottomSideSphere);
-	bottomSideSphere->setPos(bottom->pVerticesNonEmpty()->at(1).getPos());
-	bottomSideSphere->setMaterial(values->brownBlank);
+//=========================================================//
 
+void VFBlock::releaseCollisionDetectors(void)
+{
+	cylinder->deleteCollisionDetector(true);
+	top->deleteCollisionDetector(true);
+	bottom->deleteCollisionDetector(true);
 }
 
+
 //=========================================================//
 
 void VFBlock::measureInitialCylinderDimensions(void)
 {
 	// calculate height
-	height = cDistance(topCenterSphere->getPos(), bottomCenterSphere->getPos());
+	height = cDistance(topCenterPos, bottomCenterPos);
 
 	// calculate radius
-	radius = cDistance(topCenterSphere->getPos(), topSideSphere->getPos());
+	radius = cDistance(topCenterPos, topSidePos);
 }
 
 //=========================================================//
@@ -214,7 +281,7 @@ void VFBlock::setStiffnessStatus(bool status)
 		cylinderMaterial.setStiffness(0.4 * values->stiffnessMax);
 		cylinder->setMaterial(cylinderMaterial, true, true);
 		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
+		updateCollisionDetector(cylinder, collisionName + " body");
 		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
 		top->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
 		bottom->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
@@ -224,7 +291,7 @@ void VFBlock::setStiffnessStatus(bool status)
 		cylinderMaterial.setStiffness(0);
 		cylinder->setMaterial(cylinderMaterial, true, true);
 		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
+		updateCollisionDetector(cylinder, collisionName + " body");
 		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
 		top->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
 		bottom->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
@@ -255,68 +322,58 @@ void VFBlock::setHide(bool status)
 
 void VFBlock::removeFromWorld(void)
 {
-	values->world->removeChild(top);
-	values->world->removeChild(cylinder);
-	values->world->removeChild(bottom);
+	values->fixtureCollisionRoot->removeChild(top);
+	values->fixtureCollisionRoot->removeChild(cylinder);
+	values->fixtureCollisionRoot->removeChild(bottom);
 }
 
 //=========================================================//
 
-void VFBlock::updateHaptics()
+void VFBlock::onWallContact(ContactEventType type)
 {
-	if(collisionFlag)
+	// the contacts with the wall are counted in every configuration; without
+	// forbidden-region feedback the wall simply has no stiffness
+	if(type == CONTACT_ENTERED)
 	{
-		if(!values->tool->isInContact(cylinder->getChild(0)))
-		{
-			values->numOfCollisions++;
-			writeForceToFile(values->tool->m_lastComputedGlobalForce);
-			collisionFlag = false;
-		}
-	}else
+		collisionFlag = true;
+	}else if(collisionFlag)
 	{
-		if(values->tool->isInContact(cylinder->getChild(0)))
-			collisionFlag = true;
+		// the force is written to file by the session service, with where along the path it happened
+		values->numOfCollisions++;
+		values->sessionEvents->push(SESSION_COLLISION_ENDED, values->hapticTime, values->tool->m_lastComputedGlobalForce,
+			values->pathProgress->getProgress(), values->pathProgress->getDeviation());
+		collisionFlag = false;
 	}
-	
-
-	values->tool->applyForces();
 }
 
 //=========================================================//
 
-void VFBlock::writeForceToFile(cVector3d force)
+void VFBlock::subscribeContacts(ContactSubscriptionMap& subscriptions)
 {
-	double x, y, z;
-
-	x = force.x;
-	y = force.y;
-	z = force.z;
+	ContactSubscription subscription;
+	subscription.role	= CONTACT_BLOCK_WALL;
+	subscription.block	= this;
+	subscription.line	= NULL;
 
-    values->outfileForces<<x<<" "<<y<<" "<<z<<endl;
+	subscriptions[cylinder->getChild(0)] = subscription;
 }
 
 //=========================================================//
 
 void VFBlock::setHighlightBlockAsActive(bool status)
 {
+	// called from the haptic thread; only the color changes, so the stiffness and the
+	// collision tree of the cylinder are left alone and the color is set by the graphics thread.
+	// Only used by the pipelines with visual feedback
 	if(status)
 	{
-		if(values->V)
-			cylinderMaterial.m_ambient.set(0.8,0.1,0.1,1);
-		cylinderMaterial.setStiffness(values->cylinderStiffness);
-		cylinder->setMaterial(cylinderMaterial, true, true);
-		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
+		cylinderMaterial.m_ambient.set(0.8,0.1,0.1,1);
+		values->sceneCommands->setAmbientColor(cylinder, cylinderMaterial.m_ambient);
 	}
 	else
 	{
 		cylinderMaterial.m_ambient.set(0.0,0.0,0.0,0);
-		cylinderMaterial.setStiffness(values->cylinderStiffness);
-		cylinder->setMaterial(cylinderMaterial, true, true);
-		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
+		values->sceneCommands->setAmbientColor(cylinder, cylinderMaterial.m_ambient);
 	}
 }
 
@@ -327,18 +384,29 @@ void VFBlock::setHighlightBlockAsActive(bool status)
 //==================TRANSFORMATIONS========================//
 //=========================================================*/
 
+void VFBlock::scaleMarks(cVector3d scaleFactors)
+{
+	// the marks follow the vertices of the top and bottom meshes
+	topSidePos.elementMul(scaleFactors);
+	topCenterPos.elementMul(scaleFactors);
+	bottomCenterPos.elementMul(scaleFactors);
+	bottomSidePos.elementMul(scaleFactors);
+}
+
+//=========================================================//
+
 void VFBlock::scale(double scaleFactor)
 {
 	cylinder->scale(scaleFactor);
 	top->scale(scaleFactor);
 	bottom->scale(scaleFactor);
+	scaleMarks(cVector3d(scaleFactor,scaleFactor,scaleFactor));
 
 	radius = radius*scaleFactor;
 	height = height*scaleFactor;
+	meshScale = meshScale * scaleFactor;
 
-	cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-	top->createAABBCollisionDetector(values->proxyRadius, true, false);
-	bottom->createAABBCollisionDetector(values->proxyRadius, true, false);
+	updateCollisionDetectors();
 
 	// changes the standard radius in the program in case of scaling the blocks
 	values->stdBlockRadius = radius; 
@@ -352,12 +420,12 @@ void VFBlock::scaleHeight(double scaleFactor)
 	cylinder->scale(cVector3d(1,1,scaleFactor), true);
 	top->scale(cVector3d(1,1,scaleFactor), true);
 	bottom->scale(cVector3d(1,1,scaleFactor), true);
+	scaleMarks(cVector3d(1,1,scaleFactor));
 
 	height = height*scaleFactor;
+	meshScale.z = meshScale.z*scaleFactor;
 
-	cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-	top->createAABBCollisionDetector(values->proxyRadius, true, false);
-	bottom->createAABBCollisionDetector(values->proxyRadius, true, false);
+	updateCollisionDetectors();
 
 }
 
@@ -368,15 +436,17 @@ void VFBlock::scaleRadius(double scaleFactor)
 	cylinder->scale(cVector3d(scaleFactor,scaleFactor,1), true);
 	top->scale(cVector3d(scaleFactor,scaleFactor,1), true);
 	bottom->scale(cVector3d(scaleFactor,scaleFactor,1), true);
+	scaleMarks(cVector3d(scaleFactor,scaleFactor,1));
 
 	radius = radius*scaleFactor;
 	values->stdBlockRadius = radius;
+	meshScale.x = meshScale.x*scaleFactor;
+	meshScale.y = meshScale.y*scaleFactor;
 
-	cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-	top->createAABBCollisionDetector(values->proxyRadius, true, false);
-	bottom->createAABBCollisionDetector(values->proxyRadius, true, false);
+	updateCollisionDetectors();
 }
 
+
 //=========================================================//
 
 void VFBlock::translate(double x, double y, double z)
@@ -468,9 +538,9 @@ cVector3d VFBlock::getTopCenterGlobalPos()
 
 	bool ghostStatus = top->getAsGhost();
 	if(ghostStatus==true) top->setAsGhost(false);
-	values->world->computeGlobalPositions();
+	values->fixtureCollisionRoot->computeGlobalPositions();
 	top->computeGlobalPositions();
-	position = topCenterSphere->getGlobalPos();	
+	position = cAdd(top->getGlobalPos(), cMul(top->getGlobalRot(), topCenterPos));
 	top->setAsGhost(ghostStatus);
 
 	return position;
@@ -482,9 +552,9 @@ cVector3d VFBlock::getTopSideGlobalPos()
 
 	bool ghostStatus = top->getAsGhost();
 	if(ghostStatus==true) top->setAsGhost(false);
-	values->world->computeGlobalPositions();
+	values->fixtureCollisionRoot->computeGlobalPositions();
 	top->computeGlobalPositions();
-	position = topSideSphere->getGlobalPos();	
+	position = cAdd(top->getGlobalPos(), cMul(top->getGlobalRot(), topSidePos));
 	top->setAsGhost(ghostStatus);
 
 	return position;
@@ -496,9 +566,9 @@ cVector3d VFBlock::getBottomCenterGlobalPos()
 
 	bool ghostStatus = bottom->getAsGhost();
 	if(ghostStatus==true) bottom->setAsGhost(false);
-	values->world->computeGlobalPositions();
+	values->fixtureCollisionRoot->computeGlobalPositions();
 	bottom->computeGlobalPositions();
-	position = bottomCenterSphere->getGlobalPos();	
+	position = cAdd(bottom->getGlobalPos(), cMul(bottom->getGlobalRot(), bottomCenterPos));
 	bottom->setAsGhost(ghostStatus);
 
 	return position;
@@ -510,9 +580,9 @@ cVector3d VFBlock::getBottomSideGlobalPos()
 
 	bool ghostStatus = bottom->getAsGhost();
 	if(ghostStatus==true) bottom->setAsGhost(false);
-	values->world->computeGlobalPositions();
+	values->fixtureCollisionRoot->computeGlobalPositions();
 	bottom->computeGlobalPositions();
-	position = bottomSideSphere->getGlobalPos();	
+	position = cAdd(bottom->getGlobalPos(), cMul(bottom->getGlobalRot(), bottomSidePos));
 	bottom->setAsGhost(ghostStatus);
 
 	return position;
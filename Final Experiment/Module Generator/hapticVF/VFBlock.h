@@ -33,10 +33,12 @@ protected:
 	cMesh*					top; 
 	cMesh*					bottom;	
 	
-	cShapeSphere*			topSideSphere;
-	cShapeSphere*			bottomCenterSphere;
-	cShapeSphere*			topCenterSphere;
-	cShapeSphere*			bottomSideSphere;
+	// marked points in the frames of the top and bottom meshes; kept as positions
+	// rather than marker nodes so that nothing but the meshes is in the collision scene
+	cVector3d				topSidePos;
+	cVector3d				bottomCenterPos;
+	cVector3d				topCenterPos;
+	cVector3d				bottomSidePos;
 	
 
 	double					height;
@@ -48,14 +50,35 @@ protected:
 
 	bool					collisionFlag;
 
+	// scaling of the meshes since they were loaded or generated; the blocks share the collision
+	// trees of the meshes under the same name, scaled by it
+	cVector3d				meshScale;
+	string					collisionName;
+
 	cMaterial				cylinderMaterial;
+
+	// the meshes of the files, loaded once and copied into every block; kept for good (build thread only)
+	static map<string, cMesh*>	prototypeMeshes;
 	
 
 	//========================[METHODS]========================//
 
+	// constructor; if not imported, the meshes are left to the derived structure (see Corner)
+	VFBlock(bool isImported);
+	void			initialize(bool isImported);
 	void			importMeshes(void);
+	// a copy of the meshes of the file, which is loaded the first time only
+	cMesh*			createMeshFromFile(string modelPath, string partName);
+	// copies the vertices, triangles and material of the mesh and of its child meshes
+	void			copyMesh(cMesh* source, cMesh* target);
 	void			setupInitialMeshesProperties(void);
+	// material, transparency and culling of the meshes
+	void			setupMeshesAppearance(void);
 	void			measureInitialCylinderDimensions(void);
+	// scales the marked points together with the meshes
+	void			scaleMarks(cVector3d scaleFactors);
+	void			updateCollisionDetector(cMesh* mesh, string prototypeName);
+
 
 /*=========================================================//
 //========================[PUBLIC]=========================//
@@ -71,8 +94,10 @@ public:
 
 	// constructor
 	VFBlock();
-	// called inside the main haptic loop in the program
-	void		updateHaptics(void);
+	// called by the fixture pipeline of the module when the proxy touches or leaves the wall
+	void		onWallContact(ContactEventType type);
+	// registers the wall for the contact events (see ContactEventStream)
+	void		subscribeContacts(ContactSubscriptionMap& subscriptions);
 	// sets the VFBlock as a ghost; no collision enabled
 	void		setAsGhost(bool status);	
 	// if set to true, the VFBlock is no longer graphically visible
@@ -81,10 +106,13 @@ public:
 	void		setStiffnessStatus(bool status);
 	// removes the block from the world
 	void		removeFromWorld(void);
-	// writes force data to file (adds a new row)
-	void		writeForceToFile(cVector3d force);
 	// highlights the color of the VFBlock to reddish
 	void		setHighlightBlockAsActive(bool status);
+	// replaces the collision detectors of the meshes, after they changed or were released
+	void		updateCollisionDetectors(void);
+	// deletes the collision detectors of the meshes while the block is out of the collision scene
+	void		releaseCollisionDetectors(void);
+
 
 	//========================[METHODS]=====transformations===//
 
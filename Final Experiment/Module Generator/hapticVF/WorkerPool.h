@@ -0,0 +1,110 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Final Experiment - Module Generator
+
+[Worker Pool]
+This is a singleton class that owns a fixed set of worker threads used for
+the heavy setup work (mesh parsing, normals computation) so that it can be
+split across all the available CPU cores.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+// a task executed by a worker thread
+typedef void (*WorkerTask)(void* arg);
+// a task executed over the index range [begin, end) by a worker thread
+typedef void (*WorkerRangeTask)(int begin, int end, void* arg);
+
+#if defined(_WIN32)
+typedef CRITICAL_SECTION	WorkerMutex;
+typedef CONDITION_VARIABLE	WorkerCondition;
+typedef HANDLE				WorkerThread;
+#else
+typedef pthread_mutex_t		WorkerMutex;
+typedef pthread_cond_t		WorkerCondition;
+typedef pthread_t			WorkerThread;
+#endif
+
+// counts the jobs of one batch so that the batch can be waited for
+typedef struct WorkerGroup{
+
+public:
+	int pendingJobs;
+	WorkerGroup();
+
+};
+
+class WorkerPool
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	struct Job
+	{
+		WorkerTask		task;
+		void*			arg;
+		WorkerGroup*	group;
+	};
+
+    static bool			instanceFlag;
+    static WorkerPool*	single;
+
+	int						numThreads;
+	bool					isStopping;
+	deque<Job>				jobs;
+	vector<WorkerThread>	threads;
+	WorkerMutex				mutex;
+	WorkerCondition			jobAvailable;
+	WorkerCondition			jobDone;
+
+	//========================[METHODS]========================//
+	// constructor; starts the worker threads (0 = one per core)
+	WorkerPool(int numThreads);
+	// the loop run by every worker thread
+	void		workerLoop(void);
+	// runs one job outside the lock and marks it as done
+	void		runJob(Job job);
+
+	void		lock(void);
+	void		unlock(void);
+	void		waitCondition(WorkerCondition* condition);
+	void		wakeAll(WorkerCondition* condition);
+
+#if defined(_WIN32)
+	static unsigned __stdcall	threadEntry(void* pool);
+#else
+	static void*				threadEntry(void* pool);
+#endif
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// returns the unique instance of WorkerPool
+    static WorkerPool*	getInstance(void);
+	// returns the number of cores of the machine
+	static int			getHardwareConcurrency(void);
+	// destructor; joins all the worker threads
+    ~WorkerPool(void);
+
+	// queues a task; pass a group to be able to wait for it later
+	void		submit(WorkerTask task, void* arg, WorkerGroup* group = NULL);
+	// blocks until all the tasks of the group are done;
+	// the calling thread runs queued tasks meanwhile, so it is safe to call from a task
+	void		wait(WorkerGroup* group);
+	// splits [0, count) into chunks and runs them on the pool, returns when all are done
+	void		parallelFor(int count, WorkerRangeTask task, void* arg);
+	// returns the number of worker threads
+	int			getNumThreads(void);
+};
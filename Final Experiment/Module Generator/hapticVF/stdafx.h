@@ -10,20 +10,63 @@
 #include <string.h>
 #include <sstream>
 #include <stdio.h>
+#if defined(_WIN32)
 #include <tchar.h>
+#endif
 #include <time.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <stdlib.h>
+#include <deque>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <emmintrin.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 // additional headers 
 #include "chai3d.h"
 #include "targetver.h"
+#include "Atomic.h"
+#include "MonotonicClock.h"
+#include "WorkerPool.h"
+#include "ThreadEvent.h"
+#include "ParallelMeshLoader.h"
+#include "SignedDistanceField.h"
+#include "MeshCollisionBVH.h"
+
+#include "ProgressiveFieldBaker.h"
+#include "HapticSnapshot.h"
+#include "FramePacer.h"
+#include "SceneCommandQueue.h"
+#include "SessionEventQueue.h"
+#include "GuidanceForceLaw.h"
+#include "ForceProfile.h"
+#include "GatedMagnetEffect.h"
 #include "Point.h"
+#include "PathProgress.h"
+#include "GuidanceVectorField.h"
+
 #include "CommonValues.h"
+#include "ContactEventStream.h"
+#include "CornerGeometry.h"
 #include "VFBlock.h"
 #include "Corner.h"
-#include "MagneticLine.h"
\ No newline at end of file
+#include "MagneticLine.h"
+#include "FixturePipeline.h"
+#include "FixtureWindow.h"
+#include "PathArena.h"
+
+#include "ModuleRunner.h"
+#include "TrialMetrics.h"
+#include "SessionService.h"
\ No newline at end of file
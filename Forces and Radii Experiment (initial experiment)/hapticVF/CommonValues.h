@@ -63,6 +63,7 @@ public:
 	double					totalNumCollisions;
 	ofstream				outfileForces;
 	ofstream				outfileCollisionTime;
+	FixtureChannels			channels;			// GVF/FRVF/display enable masks read by the loops
 
 	//========================[CONSTANTS]======================//
 	static const double CORNER_SCALE_FACTOR;
@@ -33,6 +33,8 @@ Corner::Corner()
 
 	cylinder->setFrameSize(0.5, 0.2, true);
 
+	group = GROUP_CORNERS;
+
 }
 
 //=========================================================//
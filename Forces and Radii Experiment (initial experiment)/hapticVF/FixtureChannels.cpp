@@ -0,0 +1,84 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Initial Experiment 
+
+[Fixture Channels]
+Enable masks for the feedback channels of the virtual fixtures (guidance,
+forbidden region and their graphical display). A channel is on for a fixture
+when it is on both globally and for the fixture's group.
+Toggling a channel only changes a mask; each fixture picks the change up the
+next time the haptic or graphics loop reaches it, and no geometry is rebuilt.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+FixtureChannels::FixtureChannels(void)
+{
+	globalMask = ALL_CHANNELS;
+	for(int i=0; i<NUM_FIXTURE_GROUPS; i++)
+		groupMasks[i] = ALL_CHANNELS;
+	version = 0;
+}
+
+//=========================================================//
+
+void FixtureChannels::setEnabled(long channels, bool status)
+{
+	long mask = atomicLoad(&globalMask);
+	atomicStore(&globalMask, status ? (mask | channels) : (mask & ~channels));
+
+	// the version is bumped after the mask so that a fixture seeing it also sees the mask
+	atomicIncrement(&version);
+}
+
+//=========================================================//
+
+void FixtureChannels::setEnabled(long channels, FixtureGroup group, bool status)
+{
+	long mask = atomicLoad(&groupMasks[group]);
+	atomicStore(&groupMasks[group], status ? (mask | channels) : (mask & ~channels));
+
+	atomicIncrement(&version);
+}
+
+//=========================================================//
+
+bool FixtureChannels::isEnabled(long channel)
+{
+	return (atomicLoad(&globalMask) & channel) != 0;
+}
+
+//=========================================================//
+
+bool FixtureChannels::isEnabled(long channel, FixtureGroup group)
+{
+	return (atomicLoad(&globalMask) & atomicLoad(&groupMasks[group]) & channel) != 0;
+}
+
+//=========================================================//
+
+void FixtureChannels::notifyChanged(void)
+{
+	atomicIncrement(&version);
+}
+
+//=========================================================//
+
+long FixtureChannels::getVersion(void)
+{
+	return atomicLoad(&version);
+}
+
+//=========================================================//
@@ -0,0 +1,69 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Initial Experiment 
+
+[Fixture Channels]
+Enable masks for the feedback channels of the virtual fixtures (guidance,
+forbidden region and their graphical display). A channel is on for a fixture
+when it is on both globally and for the fixture's group.
+Toggling a channel only changes a mask; each fixture picks the change up the
+next time the haptic or graphics loop reaches it, and no geometry is rebuilt.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+enum FixtureChannel
+{
+	CHANNEL_GUIDANCE			= 1,	// GVF: magnetic lines and the block caps
+	CHANNEL_FORBIDDEN_REGION	= 2,	// FRVF: stiffness of the block walls
+	CHANNEL_DISPLAY				= 4,	// graphical display of the blocks and corners
+	CHANNEL_GUIDANCE_LINES		= 8,	// graphical display of the red magnetic lines
+	ALL_CHANNELS				= 15
+};
+
+enum FixtureGroup
+{
+	GROUP_BLOCKS,
+	GROUP_CORNERS,
+	NUM_FIXTURE_GROUPS
+};
+
+class FixtureChannels
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[VARIABLES]======================//
+	volatile long	globalMask;
+	volatile long	groupMasks[NUM_FIXTURE_GROUPS];
+	volatile long	version;		// bumped after every change
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// constructor; every channel starts enabled
+	FixtureChannels(void);
+	// enables or disables the channels for all the fixtures
+	void		setEnabled(long channels, bool status);
+	// enables or disables the channels for one group of fixtures
+	void		setEnabled(long channels, FixtureGroup group, bool status);
+	// returns true if the channel is enabled globally
+	bool		isEnabled(long channel);
+	// returns true if the channel is enabled globally and for the group
+	bool		isEnabled(long channel, FixtureGroup group);
+	// signals a change that is not a mask (e.g. the guidance force scale factor)
+	void		notifyChanged(void);
+	// fixtures compare this with the version they last applied
+	long		getVersion(void);
+};
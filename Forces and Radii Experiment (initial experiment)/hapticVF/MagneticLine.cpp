@@ -35,6 +35,13 @@ MagneticLine::MagneticLine(cVector3d A, cVector3d B)
 
 	this->isSecondLine = false;
 	this->isLastLine = false;
+
+	this->isMagneticPathAdded = false;
+	this->isGuidanceChannelOn = true;
+	this->isLineHidden = false;
+	this->appliedForceScaleFactor = values->forceScaleFactor;
+	this->hapticChannelsVersion = values->channels.getVersion();
+	this->displayChannelsVersion = this->hapticChannelsVersion;
 }
 
 //=========================================================//
@@ -52,6 +59,13 @@ MagneticLine::MagneticLine(void)
 
 	this->isSecondLine = false;
 	this->isLastLine = false;
+
+	this->isMagneticPathAdded = false;
+	this->isGuidanceChannelOn = true;
+	this->isLineHidden = false;
+	this->appliedForceScaleFactor = values->forceScaleFactor;
+	this->hapticChannelsVersion = values->channels.getVersion();
+	this->displayChannelsVersion = this->hapticChannelsVersion;
 }
 
 //=========================================================//
@@ -113,9 +127,66 @@ void MagneticLine::setupInitialForceField(void)
 
 //=========================================================//
 
+void MagneticLine::updateChannels(void)
+{
+	long channelsVersion = values->channels.getVersion();
+	if(channelsVersion == hapticChannelsVersion)
+		return;
+
+	hapticChannelsVersion = channelsVersion;
+
+	bool status = values->channels.isEnabled(CHANNEL_GUIDANCE, block->getGroup());
+	if(status != isGuidanceChannelOn)
+	{
+		isGuidanceChannelOn = status;
+
+		if(isGuidanceChannelOn)
+		{
+			// back to where the line was when guidance was disabled
+			block->getTopMesh()->setAsGhost(isForceFieldEnabled);
+			block->getBottomMesh()->setAsGhost(!isForceFieldEnabled);
+			setForceFieldStatus(isForceFieldEnabled);
+		}
+		else
+		{
+			block->getTopMesh()->setAsGhost(true);
+			block->getBottomMesh()->setAsGhost(true);
+			setForceFieldStatus(false);
+		}
+	}
+
+	if(appliedForceScaleFactor != values->forceScaleFactor)
+	{
+		appliedForceScaleFactor = values->forceScaleFactor;
+		scaleForce();
+	}
+}
+
+//=========================================================//
+
+void MagneticLine::updateDisplay(void)
+{
+	long channelsVersion = values->channels.getVersion();
+	if(channelsVersion == displayChannelsVersion)
+		return;
+
+	displayChannelsVersion = channelsVersion;
+
+	bool status = values->channels.isEnabled(CHANNEL_GUIDANCE_LINES, block->getGroup());
+	if(status == isLineHidden)
+	{
+		setLineTransparency(!status);
+		isLineHidden = !status;
+	}
+}
+
+//=========================================================//
+
 void MagneticLine::updateHaptics(void)
 {
-	if(isGuidanceOn)
+	updateChannels();
+
+	if(isGuidanceOn && isGuidanceChannelOn)
 	{
 		if(values->tool->isInContact(block->getTopMesh()->getChild(0)))
 		{
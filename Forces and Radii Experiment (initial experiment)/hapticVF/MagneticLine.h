@@ -38,11 +38,18 @@ protected:
 	bool			isGuidanceOn;
 	bool			isForceFieldEnabled;
 	bool			isMagneticPathAdded;
+	bool			isGuidanceChannelOn;
+	bool			isLineHidden;
+	double			appliedForceScaleFactor;
+	long			hapticChannelsVersion;
+	long			displayChannelsVersion;
 
 	//========================[METHODS]========================//
 	// calculates the height scale factor w.r.t. the standard height
 	// this helps to obtain the corresponding magnetic force proportional to the line's height
 	void		calculateHeightScaleFactor(void);
+	// applies the guidance channel and the force scale factor after they have been changed
+	void		updateChannels(void);
 
 public:
 	//========================[VARIABLES]======================//	
@@ -60,6 +67,8 @@ public:
 	void		setBlock(VFBlock* block);
 	// include this in the main haptic loop
 	void		updateHaptics(void);
+	// include this in the graphics loop; applies the red line display channel
+	void		updateDisplay(void);
 	// prints the details of the lines (its coordinates and length)
 	void		print();
 	// sets the forcefield of the line on or off
@@ -84,6 +84,7 @@ void					setStartingPointStatus(bool status);
 void					updateGraphics(void);
 void					updateHaptics(void);
 void					updateCameraPosition(void);
+void					updateFixtureDisplay(void);
 void					startSimulation(void);
 
 // ---------------- algorithm methods - functional
@@ -105,9 +106,8 @@ double					getAngleBetweenLines(MagneticLine* prevline, MagneticLine* line);
 
 
 
-bool gvfEnabled = true; // guidance virtual fixtures
-bool frvfEnabled = true; // forbidden-region virtual fixtures
-bool graphicalDisplayEnabled = true; //graphical feedback of gvf and frvf
+// last fixture channel change applied to the display (see updateFixtureDisplay)
+long displayedChannelsVersion = 0;
 
 
 /*=========================================================//
@@ -371,35 +371,12 @@ void keySelect(unsigned char key, int x, int y)
 	}
 
 
+	// the fixture channels only flip a mask here; the haptic and graphics loops apply it
 	if(key=='q')
 	{
-		if(!gvfEnabled){
+		if(!values->channels.isEnabled(CHANNEL_GUIDANCE)){
 			printf("\nGVF is now enabled\n");
-			gvfEnabled = true;
-			MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->setGuidance(true);
-				tempLines = tempLines->next;   
-			}
-
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->getTopMesh()->setAsGhost(false);
-				tempblocks->getBottomMesh()->setAsGhost(false);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->getTopMesh()->setAsGhost(false);
-				tempcorners->getBottomMesh()->setAsGhost(false);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_GUIDANCE, true);
 		}
 		else
 			printf("\nGVF is already enabled\n");
@@ -407,33 +384,9 @@ void keySelect(unsigned char key, int x, int y)
 
 	if(key=='w')
 	{
-		if(gvfEnabled){
+		if(values->channels.isEnabled(CHANNEL_GUIDANCE)){
 			printf("\nGVF is now disabled\n");
-			gvfEnabled = false;
-			MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->setGuidance(false);
-				tempLines = tempLines->next;   
-			}
-
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->getTopMesh()->setAsGhost(true);
-				tempblocks->getBottomMesh()->setAsGhost(true);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->getTopMesh()->setAsGhost(true);
-				tempcorners->getBottomMesh()->setAsGhost(true);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_GUIDANCE, false);
 		}
 		else
 			printf("\nGVF is already disabled\n");
@@ -441,25 +394,10 @@ void keySelect(unsigned char key, int x, int y)
 
 	if(key=='e')
 	{
-		if(!frvfEnabled)
+		if(!values->channels.isEnabled(CHANNEL_FORBIDDEN_REGION))
 		{
 			printf("\nFRVF is now enabled\n");
-			frvfEnabled = true;
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->setStiffnessStatus(true);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->setStiffnessStatus(true);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_FORBIDDEN_REGION, true);
 		}
 		else
 			printf("\nFRVF is already enabled\n");
@@ -467,25 +405,10 @@ void keySelect(unsigned char key, int x, int y)
 
 	if(key=='r')
 	{
-		if(frvfEnabled)
+		if(values->channels.isEnabled(CHANNEL_FORBIDDEN_REGION))
 		{
 			printf("\nFRVF is now disabled\n");
-			frvfEnabled = false;
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->setStiffnessStatus(false);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->setStiffnessStatus(false);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_FORBIDDEN_REGION, false);
 		}
 		else
 			printf("\nFRVF is already disabled\n");
@@ -493,25 +416,10 @@ void keySelect(unsigned char key, int x, int y)
 
 	if(key=='t')
 	{
-		if(graphicalDisplayEnabled)
+		if(values->channels.isEnabled(CHANNEL_DISPLAY))
 		{
 			printf("\nVF graphical display is now disabled\n");
-			graphicalDisplayEnabled = false;
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->setHide(true);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->setHide(true);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_DISPLAY, false);
 		}
 		else
 			printf("\nVF graphical display is already disabled\n");
@@ -519,25 +427,10 @@ void keySelect(unsigned char key, int x, int y)
 
 	if(key=='y')
 	{
-		if(!graphicalDisplayEnabled)
+		if(!values->channels.isEnabled(CHANNEL_DISPLAY))
 		{
 			printf("\nVF graphical display is now enabled\n");
-			graphicalDisplayEnabled = true;
-			VFBlock* tempblocks = createdVFBlocks;
-			tempblocks = createdVFBlocks;
-			while( tempblocks!=NULL )
-			{
-				tempblocks->setHide(false);
-				tempblocks = tempblocks->next;   
-			}
-
-			Corner* tempcorners = createdCorners;
-			tempcorners = createdCorners;
-			while( tempcorners!=NULL )
-			{
-				tempcorners->setHide(false);
-				tempcorners = tempcorners->next;   
-			}
+			values->channels.setEnabled(CHANNEL_DISPLAY, true);
 		}
 		else
 			printf("\nVF graphical display is already enabled\n");
@@ -558,12 +451,8 @@ void keySelect(unsigned char key, int x, int y)
 		{
 			values->forceScaleFactor = values->forceScaleFactor - 0.1;
 			printf("\nGuidance Force Scale Factor = %1.2f\n", values->forceScaleFactor);
-			MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->scaleForce();
-				tempLines = tempLines->next;   
-			}
+			// the lines rescale their forces the next time the haptic loop reaches them
+			values->channels.notifyChanged();
 		}
 	}
 
@@ -577,12 +466,8 @@ void keySelect(unsigned char key, int x, int y)
 		{
 			values->forceScaleFactor = values->forceScaleFactor + 0.1;
 			printf("\nGuidance Force Scale Factor = %1.2f\n", values->forceScaleFactor);
-			MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->scaleForce();
-				tempLines = tempLines->next;   
-			}
+			// the lines rescale their forces the next time the haptic loop reaches them
+			values->channels.notifyChanged();
 		}	
 	
 	}
@@ -626,23 +511,13 @@ void keySelect(unsigned char key, int x, int y)
 	if(key=='j')
 	{
 		printf("\nRed magnetic lines are now visually hidden\n");
-		MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->setLineTransparency(true);
-				tempLines = tempLines->next;   
-			}
+		values->channels.setEnabled(CHANNEL_GUIDANCE_LINES, false);
 	}
 
 	if(key=='k')
 	{
 		printf("\nRed magnetic lines are no longer visually hidden\n");
-		MagneticLine* tempLines = createdLines;
-			while( tempLines!=NULL )
-			{
-				tempLines->setLineTransparency(false);
-				tempLines = tempLines->next;   
-			}
+		values->channels.setEnabled(CHANNEL_GUIDANCE_LINES, true);
 	}
 
 }
@@ -708,6 +583,8 @@ void close(void)
 
 void updateGraphics(void)
 {
+	updateFixtureDisplay();
+
     camera->renderView(displayW, displayH);
 
     glutSwapBuffers();
@@ -724,6 +601,39 @@ void updateGraphics(void)
 
 //=========================================================//
 
+void updateFixtureDisplay(void)
+{
+	// nothing to do unless a fixture channel has been toggled since the last frame
+	long channelsVersion = values->channels.getVersion();
+	if(channelsVersion == displayedChannelsVersion)
+		return;
+
+	displayedChannelsVersion = channelsVersion;
+
+	MagneticLine* tempLines = createdLines;
+	while( tempLines!=NULL )
+	{
+		tempLines->updateDisplay();
+		tempLines = tempLines->next;   
+	}
+
+	VFBlock* tempBlocks = createdVFBlocks;
+	while( tempBlocks!=NULL )
+	{
+		tempBlocks->updateDisplay();
+		tempBlocks = tempBlocks->next;   
+	}
+
+	Corner* tempCorners = createdCorners;
+	while( tempCorners!=NULL )
+	{
+		tempCorners->updateDisplay();
+		tempCorners = tempCorners->next;   
+	}
+}
+
+//=========================================================//
+
 void updateCameraPosition()
 {
    // check values
@@ -29,6 +29,11 @@ VFBlock::VFBlock()
 	values->defaultTransparencyLevel = 0.7;
 	isHidden = false;
 	isGhost = false;	
+	isStiffnessEnabled = true;
+
+	group = GROUP_BLOCKS;
+	hapticChannelsVersion = values->channels.getVersion();
+	displayChannelsVersion = hapticChannelsVersion;
 
 	importMeshes();
 	setupInitialMeshesProperties();
@@ -207,26 +212,25 @@ void VFBlock::setStiffnessStatus(bool status)
 {
 	isStiffnessEnabled = status;
 
+	// only the stiffness changes, so the collision tree and the display are left as they are
 	if(isStiffnessEnabled)
-	{
 		cylinderMaterial.setStiffness(0.4 * values->stiffnessMax);
-		cylinder->setMaterial(cylinderMaterial, true, true);
-		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
-		top->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
-		bottom->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
-	}
 	else
-	{
 		cylinderMaterial.setStiffness(0);
-		cylinder->setMaterial(cylinderMaterial, true, true);
-		cylinder->setUseMaterial(true, true);
-		cylinder->createAABBCollisionDetector(values->proxyRadius, true, false);
-		cylinder->setTransparencyLevel(values->defaultTransparencyLevel,true,true);
-		top->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
-		bottom->setTransparencyLevel(values->defaultTransparencyLevel, true, true);
-	}
+
+	setMeshStiffness(cylinder, cylinderMaterial.getStiffness());
+}
+
+//=========================================================//
+
+void VFBlock::setMeshStiffness(cGenericObject* object, double stiffness)
+{
+	cMesh* mesh = dynamic_cast<cMesh*>(object);
+	if(mesh != NULL)
+		mesh->m_material.setStiffness(stiffness);
+
+	for(unsigned int i=0; i<object->getNumChildren(); i++)
+		setMeshStiffness(object->getChild(i), stiffness);
 }
 
 //=========================================================//
@@ -262,6 +266,17 @@ void VFBlock::removeFromWorld(void)
 
 void VFBlock::updateHaptics()
 {
+	// picks up the forbidden-region channel when it has been toggled
+	long channelsVersion = values->channels.getVersion();
+	if(channelsVersion != hapticChannelsVersion)
+	{
+		hapticChannelsVersion = channelsVersion;
+
+		bool status = values->channels.isEnabled(CHANNEL_FORBIDDEN_REGION, group);
+		if(status != isStiffnessEnabled)
+			setStiffnessStatus(status);
+	}
+
 	if(collisionFlag)
 	{
 		if(!values->tool->isInContact(cylinder->getChild(0)))
@@ -282,6 +297,21 @@ void VFBlock::updateHaptics()
 
 //=========================================================//
 
+void VFBlock::updateDisplay()
+{
+	long channelsVersion = values->channels.getVersion();
+	if(channelsVersion == displayChannelsVersion)
+		return;
+
+	displayChannelsVersion = channelsVersion;
+
+	bool status = values->channels.isEnabled(CHANNEL_DISPLAY, group);
+	if(status == isHidden)
+		setHide(!status);
+}
+
+//=========================================================//
+
 void VFBlock::writeForceToFile(cVector3d force)
 {
 	double x, y, z;
@@ -515,4 +545,11 @@ cMesh* VFBlock::getBottomMesh()
 {
 	return bottom;
 }
+
+//=========================================================//
+
+FixtureGroup VFBlock::getGroup()
+{
+	return group;
+}
 //=========================================================//
\ No newline at end of file
@@ -47,6 +47,10 @@ protected:
 	bool					isStiffnessEnabled;
 
 	bool					collisionFlag;
+
+	FixtureGroup			group;
+	long					hapticChannelsVersion;		// last channel change applied by the haptic loop
+	long					displayChannelsVersion;		// last channel change applied by the graphics loop
 	
 
 	//========================[METHODS]========================//
@@ -54,6 +58,8 @@ protected:
 	void			importMeshes(void);
 	void			setupInitialMeshesProperties(void);
 	void			measureInitialCylinderDimensions(void);
+	// writes the stiffness into every mesh of the object without touching its other properties
+	void			setMeshStiffness(cGenericObject* object, double stiffness);
 
 /*=========================================================//
 //========================[PUBLIC]=========================//
@@ -70,6 +76,8 @@ public:
 	VFBlock();
 	// called inside the main haptic loop in the program
 	void		updateHaptics(void);
+	// called inside the graphics loop; applies the display channel
+	void		updateDisplay(void);
 	// sets the VFBlock as a ghost; no collision enabled
 	void		setAsGhost(bool status);	
 	// if set to true, the VFBlock is no longer graphically visible
@@ -131,6 +139,8 @@ public:
 	cMesh*		getTopMesh();
 	// returns the cMesh* object of the cylinder bottom
 	cMesh*		getBottomMesh();
+	// returns the fixture group the VFBlock belongs to
+	FixtureGroup	getGroup();
 
 
 
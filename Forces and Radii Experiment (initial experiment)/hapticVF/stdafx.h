@@ -17,11 +17,19 @@
 #include <fstream>
 #include <stdlib.h>
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 using namespace std;
 
 // additional headers 
 #include "chai3d.h"
 #include "targetver.h"
+#include "Atomic.h"
+#include "FixtureChannels.h"
 #include "Point.h"
 #include "CommonValues.h"
 #include "VFBlock.h"
@@ -586,11 +586,12 @@ void loadModel()
 
 	model = new cMesh(values->world);
 
-	fileload = model->loadFromFile(RESOURCE_PATH(modelPath));
+	// large models are parsed and processed on all cores (see ParallelMeshLoader)
+	fileload = ParallelMeshLoader::loadFromFile(model, RESOURCE_PATH(modelPath));
 	if (!fileload)
 	{
 		#if defined(_MSVC)
-		fileload = model->loadFromFile(modelPath);
+		fileload = ParallelMeshLoader::loadFromFile(model, modelPath);
 		#endif
 	}
 	if (!fileload)
@@ -599,7 +600,7 @@ void loadModel()
 	}
 
 	// setup initial model properties
-    model->computeAllNormals(true);	
+    ParallelMeshLoader::computeAllNormals(model);
     model->computeBoundaryBox(true);
     double size = cSub(model->getBoundaryMax(), model->getBoundaryMin()).length();
     model->scale((2.0 * values->tool->getWorkspaceRadius() / size)); // scale to fit in the view
@@ -632,7 +633,6 @@ void createPoints()
 	Point* point;
 	
 	int numOfMidpoints = 0;
-	point = (Point*)malloc(sizeof(Point)); 
 	string line;
 	double x;
 	double y;
@@ -732,7 +732,6 @@ void extractMidpoints()
 
 	Point* pointsHead = NULL;
 	Point* point;
-	point = (Point*)malloc(sizeof(Point)); 
 
 	int vertNum = model->getNumVertices(true);
 	int space = 0.1 * vertNum;
@@ -792,7 +791,6 @@ void createMagneticLinesFromPoints(Point* pointsHead)
 
 	MagneticLine* linesHead = NULL;
 	MagneticLine* line;
-	line = (MagneticLine*)malloc(sizeof(MagneticLine)); 
 	point = pointsHead;
 
 	// this loop iterates over all the midpoints
@@ -842,11 +840,11 @@ void createVFBlocksFromMagneticLines(MagneticLine* linesHead)
 	// VF Blocks linked list
 	VFBlock*		prevBlock	= NULL;
 	VFBlock*		blocksHead	= NULL;
-	VFBlock*		block		= (VFBlock*)malloc(sizeof(VFBlock));
+	VFBlock*		block		= NULL;
 
 	// Corners linked list
 	Corner*			cornersHead	= NULL;
-	Corner*			corner		= (Corner*)malloc(sizeof(Corner));
+	Corner*			corner		= NULL;
 
 	// other necessary variables for the algorithms in this method
 	int				lineCount	= 0;
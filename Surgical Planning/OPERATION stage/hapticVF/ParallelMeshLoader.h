@@ -0,0 +1,45 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Surgical Planning - Operation Stage
+
+[Parallel Mesh Loader]
+Loads large anatomy models into a cMesh using all the available cores.
+OBJ files are split into chunks that are parsed concurrently and then merged
+into one child mesh per material, with the colours of their MTL files, as
+the CHAI3D loader does; OBJ files with textures and the other formats are
+delegated to CHAI3D.
+Also provides a parallel replacement for cMesh::computeAllNormals(true).
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+class ParallelMeshLoader
+{
+/*=========================================================//
+//========================[PRIVATE]========================//
+//=========================================================*/
+private:
+	//========================[METHODS]========================//
+	// parses an OBJ file into new child meshes of the given mesh, one per material
+	static bool		loadOBJ(cMesh* mesh, string fileName);
+	// computes the vertex normals of a single mesh (no children)
+	static void		computeMeshNormals(cMesh* mesh);
+
+/*=========================================================//
+//========================[PUBLIC]=========================//
+//=========================================================*/
+public:
+	//========================[METHODS]========================//
+	// loads the model file into the mesh; drop-in replacement of cMesh::loadFromFile
+	static bool		loadFromFile(cMesh* mesh, string fileName);
+	// computes the vertex normals of the mesh and all of its child meshes in parallel
+	static void		computeAllNormals(cMesh* mesh);
+};
@@ -515,11 +515,12 @@ void loadModel()
 
 	model = new cMesh(values->world);
 
-	fileload = model->loadFromFile(RESOURCE_PATH(modelPath));
+	// large models are parsed and processed on all cores (see ParallelMeshLoader)
+	fileload = ParallelMeshLoader::loadFromFile(model, RESOURCE_PATH(modelPath));
 	if (!fileload)
 	{
 		#if defined(_MSVC)
-		fileload = model->loadFromFile(modelPath);
+		fileload = ParallelMeshLoader::loadFromFile(model, modelPath);
 		#endif
 	}
 	if (!fileload)
@@ -528,7 +529,7 @@ void loadModel()
 	}
 
 	// setup initial model properties
-    model->computeAllNormals(true);	
+    ParallelMeshLoader::computeAllNormals(model);
     model->computeBoundaryBox(true);
     double size = cSub(model->getBoundaryMax(), model->getBoundaryMin()).length();
     model->scale((2.0 * values->tool->getWorkspaceRadius() / size)); // scale to fit in the view
@@ -609,8 +610,6 @@ void addPoint(cVector3d location)
 	{
 		Point* point;
 
-		point = (Point*)malloc(sizeof(Point)); 
-
 		point = new Point(location);
 		point->next=createdPoints;
 		createdPoints = point; 
@@ -629,7 +628,7 @@ void deleteLastAddedPoint()
 		if(temp->next!=NULL)createdPoints = temp->next; // makes sure the linked list is not empty then deletes the point
 		else
 			createdPoints = NULL;
-		free(temp); // frees up the memory taken by the deleted point
+		delete temp; // frees up the memory taken by the deleted point; its sphere stays in the world, scaled down
 	}
 
 	printPoints(createdPoints); // prints out the points in the linked list
@@ -0,0 +1,580 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Surgical Planning - Preoperative Stage
+
+[Parallel Mesh Loader]
+Loads large anatomy models into a cMesh using all the available cores.
+OBJ files are split into chunks that are parsed concurrently and then merged
+into one child mesh per material, with the colours of their MTL files, as
+the CHAI3D loader does; OBJ files with textures and the other formats are
+delegated to CHAI3D.
+Also provides a parallel replacement for cMesh::computeAllNormals(true).
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+
+// one slice of the OBJ file, always starting and ending on a line boundary
+struct OBJChunk
+{
+	const char*		begin;
+	const char*		end;
+	int				numVertices;	// 'v' lines inside the chunk
+	int				vertexOffset;	// 'v' lines in all the chunks before this one
+	vector<double>	positions;		// x,y,z per vertex
+	vector<int>		triangles;		// 3 zero-based global vertex indices per triangle
+	vector<int>		materialStarts;	// per 'usemtl' line, the triangles of the chunk before it
+	vector<string>	materialNames;	// ... and the material it names
+	vector<string>	libraries;		// 'mtllib' file names
+};
+
+// a material of an MTL file
+struct OBJMaterial
+{
+	cMaterial		material;
+	double			transparency;	// 'd', 1 if opaque
+};
+
+// shared data of the normals computation of one mesh
+struct NormalsJob
+{
+	vector<cVertex>*	vertices;
+	vector<cTriangle>*	triangles;
+	vector<cVector3d>	faceNormals;
+	vector<int>			offsets;		// per vertex, start of its faces in faceIndices
+	vector<int>			faceIndices;	// triangles adjacent to each vertex
+};
+
+/*=========================================================//
+//==================[HELPER FUNCTIONS]=====================//
+//=========================================================*/
+
+static const char* skipBlanks(const char* p, const char* end)
+{
+	while(p < end && (*p == ' ' || *p == '\t'))
+		p++;
+	return p;
+}
+
+//=========================================================//
+
+static const char* nextLine(const char* p, const char* end)
+{
+	while(p < end && *p != '\n')
+		p++;
+	return (p < end) ? p + 1 : end;
+}
+
+//=========================================================//
+
+static const char* lineEnd(const char* p, const char* end)
+{
+	while(p < end && *p != '\r' && *p != '\n')
+		p++;
+	return p;
+}
+
+//=========================================================//
+
+static bool isKeyword(const char* p, const char* end, char key)
+{
+	return (p + 1 < end) && (p[0] == key) && (p[1] == ' ' || p[1] == '\t');
+}
+
+//=========================================================//
+
+static bool isCommand(const char* p, const char* end, const char* command)
+{
+	size_t length = strlen(command);
+	return (p + length < end) && (strncmp(p, command, length) == 0) && (p[length] == ' ' || p[length] == '\t');
+}
+
+//=========================================================//
+
+// the rest of the line, without the blanks around it
+static string readArgument(const char* p, const char* end)
+{
+	const char* last = lineEnd(p, end);
+	p = skipBlanks(p, last);
+	while(last > p && (last[-1] == ' ' || last[-1] == '\t'))
+		last--;
+	return string(p, last);
+}
+
+//=========================================================//
+
+// reads up to count numbers, never past the end of the line; the missing ones are 0
+static void readNumbers(const char* p, const char* end, double* numbers, int count)
+{
+	const char* last = lineEnd(p, end);
+	for(int i=0; i<count; i++)
+		numbers[i] = 0;
+
+	for(int i=0; i<count; i++)
+	{
+		// strtod skips line breaks, so it only starts on a character of the line
+		p = skipBlanks(p, last);
+		if(p >= last)
+			break;
+
+		char* numberEnd;
+		numbers[i] = strtod(p, &numberEnd);
+		if(numberEnd == p)
+			break;
+		p = numberEnd;
+	}
+}
+
+//=========================================================//
+
+static bool readFile(string fileName, vector<char>& buffer)
+{
+	FILE* file = fopen(fileName.c_str(), "rb");
+	if(file == NULL)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	buffer.resize(size + 1);
+	size_t bytesRead = fread(&buffer[0], 1, size, file);
+	fclose(file);
+	if((long)bytesRead != size)
+		return false;
+	buffer[size] = '\0'; // strtod/strtol stop here at the latest
+
+	return true;
+}
+
+//=========================================================//
+
+// reads the materials of an MTL file; returns false if they use textures, which only the CHAI3D
+// loader applies. A missing file leaves the default material, as CHAI3D does
+static bool loadMaterials(string fileName, map<string, OBJMaterial>& materials)
+{
+	vector<char> buffer;
+	if(!readFile(fileName, buffer))
+		return true;
+
+	const char* p		= &buffer[0];
+	const char* end		= p + buffer.size() - 1;
+	OBJMaterial* current = NULL;
+	double numbers[3];
+
+	while(p < end)
+	{
+		const char* line = skipBlanks(p, end);
+
+		if(isCommand(line, end, "newmtl"))
+		{
+			current = &materials[readArgument(line + 6, end)];
+			current->transparency = 1;
+		}
+		else if(current != NULL && (isCommand(line, end, "Ka") || isCommand(line, end, "Kd") || isCommand(line, end, "Ks")))
+		{
+			readNumbers(line + 2, end, numbers, 3);
+			cColorf color((float)numbers[0], (float)numbers[1], (float)numbers[2]);
+			if(line[1] == 'a')			current->material.m_ambient	= color;
+			else if(line[1] == 'd')		current->material.m_diffuse	= color;
+			else						current->material.m_specular	= color;
+		}
+		else if(current != NULL && isCommand(line, end, "Ns"))
+		{
+			readNumbers(line + 2, end, numbers, 1);
+			current->material.setShininess((GLuint)((numbers[0] < 0) ? 0 : (numbers[0] > 128) ? 128 : numbers[0]));
+		}
+		else if(current != NULL && isKeyword(line, end, 'd'))
+		{
+			readNumbers(line + 1, end, numbers, 1);
+			current->transparency = numbers[0];
+		}
+		else if(isCommand(line, end, "map_Kd"))
+			return false;
+
+		p = nextLine(line, end);
+	}
+
+	return true;
+}
+
+//=========================================================//
+
+static void countChunkVertices(int begin, int end, void* arg)
+{
+	vector<OBJChunk>& chunks = *(vector<OBJChunk>*)arg;
+
+	for(int c=begin; c<end; c++)
+	{
+		OBJChunk& chunk = chunks[c];
+		chunk.numVertices = 0;
+
+		const char* p = chunk.begin;
+		while(p < chunk.end)
+		{
+			const char* line = skipBlanks(p, chunk.end);
+			if(isKeyword(line, chunk.end, 'v'))
+				chunk.numVertices++;
+			p = nextLine(line, chunk.end);
+		}
+	}
+}
+
+//=========================================================//
+
+static void parseChunks(int begin, int end, void* arg)
+{
+	vector<OBJChunk>& chunks = *(vector<OBJChunk>*)arg;
+	vector<int> face;
+
+	for(int c=begin; c<end; c++)
+	{
+		OBJChunk& chunk = chunks[c];
+		chunk.positions.reserve(3 * chunk.numVertices);
+		int localVertices = 0;
+
+		const char* p = chunk.begin;
+		while(p < chunk.end)
+		{
+			const char* line = skipBlanks(p, chunk.end);
+
+			if(isKeyword(line, chunk.end, 'v'))
+			{
+				double position[3];
+				readNumbers(line + 1, chunk.end, position, 3);
+				chunk.positions.push_back(position[0]);
+				chunk.positions.push_back(position[1]);
+				chunk.positions.push_back(position[2]);
+				localVertices++;
+			}
+			else if(isCommand(line, chunk.end, "usemtl"))
+			{
+				chunk.materialStarts.push_back(chunk.triangles.size() / 3);
+				chunk.materialNames.push_back(readArgument(line + 6, chunk.end));
+			}
+			else if(isCommand(line, chunk.end, "mtllib"))
+				chunk.libraries.push_back(readArgument(line + 6, chunk.end));
+			else if(isKeyword(line, chunk.end, 'f'))
+			{
+				// tokens are "v", "v/vt", "v//vn" or "v/vt/vn"; only the position index is used
+				face.clear();
+				const char* q = line + 1;
+				while(true)
+				{
+					q = skipBlanks(q, chunk.end);
+					if(q >= chunk.end || *q == '\r' || *q == '\n')
+						break;
+
+					char* tokenEnd;
+					long index = strtol(q, &tokenEnd, 10);
+					if(tokenEnd == q)
+						break;
+
+					// negative indices are relative to the vertices declared so far
+					if(index > 0)
+						face.push_back((int)index - 1);
+					else
+						face.push_back(chunk.vertexOffset + localVertices + (int)index);
+
+					q = tokenEnd;
+					while(q < chunk.end && *q != ' ' && *q != '\t' && *q != '\r' && *q != '\n')
+						q++;
+				}
+
+				// polygons are triangulated as a fan around their first vertex
+				for(int i=1; i+1<(int)face.size(); i++)
+				{
+					chunk.triangles.push_back(face[0]);
+					chunk.triangles.push_back(face[i]);
+					chunk.triangles.push_back(face[i+1]);
+				}
+			}
+
+			p = nextLine(line, chunk.end);
+		}
+	}
+}
+
+//=========================================================//
+
+static void computeFaceNormals(int begin, int end, void* arg)
+{
+	NormalsJob& job = *(NormalsJob*)arg;
+
+	for(int t=begin; t<end; t++)
+	{
+		cTriangle& triangle = (*job.triangles)[t];
+		if(!triangle.m_allocated)
+			continue;
+
+		cVector3d v0 = (*job.vertices)[triangle.getIndexVertex0()].getPos();
+		cVector3d v1 = (*job.vertices)[triangle.getIndexVertex1()].getPos();
+		cVector3d v2 = (*job.vertices)[triangle.getIndexVertex2()].getPos();
+
+		cVector3d normal = (v1 - v0).crossAndReturn(v2 - v0);
+		if(normal.length() > 0)
+			normal.normalize();
+		job.faceNormals[t] = normal;
+	}
+}
+
+//=========================================================//
+
+static void computeVertexNormals(int begin, int end, void* arg)
+{
+	NormalsJob& job = *(NormalsJob*)arg;
+
+	for(int v=begin; v<end; v++)
+	{
+		cVector3d normal(0,0,0);
+		for(int i=job.offsets[v]; i<job.offsets[v+1]; i++)
+			normal = normal + job.faceNormals[job.faceIndices[i]];
+
+		if(normal.length() > 0)
+			normal.normalize();
+		(*job.vertices)[v].setNormal(normal);
+	}
+}
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+bool ParallelMeshLoader::loadFromFile(cMesh* mesh, string fileName)
+{
+	string extension = "";
+	size_t dot = fileName.find_last_of('.');
+	if(dot != string::npos)
+		extension = fileName.substr(dot + 1);
+	for(unsigned int i=0; i<extension.size(); i++)
+		extension[i] = (char)tolower(extension[i]);
+
+	if(extension == "obj")
+		return loadOBJ(mesh, fileName);
+
+	// 3DS is a binary chunk tree that cannot be split by offset, use the CHAI3D loader
+	return mesh->loadFromFile(fileName);
+}
+
+//=========================================================//
+
+bool ParallelMeshLoader::loadOBJ(cMesh* mesh, string fileName)
+{
+	WorkerPool* pool = WorkerPool::getInstance();
+
+	// read the whole file at once; parsing from memory is what makes the split possible
+	vector<char> buffer;
+	if(!readFile(fileName, buffer))
+		return false;
+	long size = (long)buffer.size() - 1;
+
+	const char* data	= &buffer[0];
+	const char* dataEnd	= data + size;
+
+	// split on line boundaries
+	int numChunks = pool->getNumThreads() * 4;
+	long chunkSize = size / numChunks + 1;
+	vector<OBJChunk> chunks;
+	const char* p = data;
+	while(p < dataEnd)
+	{
+		OBJChunk chunk;
+		chunk.begin = p;
+		p = (dataEnd - p > chunkSize) ? nextLine(p + chunkSize, dataEnd) : dataEnd;
+		chunk.end = p;
+		chunk.numVertices = 0;
+		chunk.vertexOffset = 0;
+		chunks.push_back(chunk);
+	}
+	if(chunks.empty())
+		return false;
+
+	// pass 1: count the vertices of every chunk to resolve relative face indices
+	pool->parallelFor(chunks.size(), countChunkVertices, &chunks);
+
+	int numVertices = 0;
+	for(unsigned int c=0; c<chunks.size(); c++)
+	{
+		chunks[c].vertexOffset = numVertices;
+		numVertices += chunks[c].numVertices;
+	}
+
+	// pass 2: parse the vertices and faces
+	pool->parallelFor(chunks.size(), parseChunks, &chunks);
+
+	if(numVertices == 0)
+		return false;
+
+	// the materials, from the libraries next to the file
+	map<string, OBJMaterial> materials;
+	string directory = fileName.substr(0, fileName.find_last_of("/\\") + 1);
+	for(unsigned int c=0; c<chunks.size(); c++)
+	{
+		for(unsigned int i=0; i<chunks[c].libraries.size(); i++)
+		{
+			if(!loadMaterials(directory + chunks[c].libraries[i], materials))
+				return mesh->loadFromFile(fileName);
+		}
+	}
+
+	// the triangles of each material, in the order of the file; the triangles before the first
+	// 'usemtl' keep the default material
+	vector<string>		groupNames(1, string(""));
+	vector<vector<int> >	groupTriangles(1);
+	map<string, int>	groupIndices;
+	groupIndices[""] = 0;
+	int group = 0;
+
+	for(unsigned int c=0; c<chunks.size(); c++)
+	{
+		const OBJChunk& chunk = chunks[c];
+		unsigned int nextSwitch = 0;
+
+		for(unsigned int t=0; t<=chunk.triangles.size() / 3; t++)
+		{
+			while(nextSwitch < chunk.materialStarts.size() && chunk.materialStarts[nextSwitch] <= (int)t)
+			{
+				const string& name = chunk.materialNames[nextSwitch++];
+				map<string, int>::iterator found = groupIndices.find(name);
+				if(found == groupIndices.end())
+				{
+					group = groupNames.size();
+					groupIndices[name] = group;
+					groupNames.push_back(name);
+					groupTriangles.push_back(vector<int>());
+				}
+				else
+					group = found->second;
+			}
+
+			if(t == chunk.triangles.size() / 3)
+				break;
+
+			int a = chunk.triangles[3*t];
+			int b = chunk.triangles[3*t+1];
+			int d = chunk.triangles[3*t+2];
+			if(a < 0 || b < 0 || d < 0 || a >= numVertices || b >= numVertices || d >= numVertices)
+				continue;
+			groupTriangles[group].push_back(a);
+			groupTriangles[group].push_back(b);
+			groupTriangles[group].push_back(d);
+		}
+	}
+
+	vector<double> positions;
+	positions.reserve(3 * numVertices);
+	for(unsigned int c=0; c<chunks.size(); c++)
+		positions.insert(positions.end(), chunks[c].positions.begin(), chunks[c].positions.end());
+
+	// one child mesh per material, with the vertices its triangles use
+	vector<int> vertexGroup(numVertices, -1);
+	vector<int> vertexIndex(numVertices, 0);
+	for(unsigned int g=0; g<groupNames.size(); g++)
+	{
+		const vector<int>& triangles = groupTriangles[g];
+		if(triangles.empty())
+			continue;
+
+		cMesh* part = new cMesh(mesh->getParentWorld());
+		mesh->addChild(part);
+
+		map<string, OBJMaterial>::iterator material = materials.find(groupNames[g]);
+		if(material != materials.end())
+		{
+			part->m_material = material->second.material;
+			if(material->second.transparency < 1)
+				part->setTransparencyLevel((float)material->second.transparency, false, false);
+		}
+
+		part->pTriangles()->reserve(triangles.size() / 3);
+		for(unsigned int i=0; i<triangles.size(); i+=3)
+		{
+			int index[3];
+			for(int k=0; k<3; k++)
+			{
+				int v = triangles[i+k];
+				if(vertexGroup[v] != (int)g)
+				{
+					vertexGroup[v] = g;
+					vertexIndex[v] = part->newVertex(positions[3*v], positions[3*v+1], positions[3*v+2]);
+				}
+				index[k] = vertexIndex[v];
+			}
+			part->newTriangle(index[0], index[1], index[2]);
+		}
+	}
+
+	return true;
+}
+
+//=========================================================//
+
+void ParallelMeshLoader::computeAllNormals(cMesh* mesh)
+{
+	computeMeshNormals(mesh);
+
+	for(unsigned int i=0; i<mesh->getNumChildren(); i++)
+	{
+		cMesh* child = dynamic_cast<cMesh*>(mesh->getChild(i));
+		if(child != NULL)
+			computeAllNormals(child);
+	}
+}
+
+//=========================================================//
+
+void ParallelMeshLoader::computeMeshNormals(cMesh* mesh)
+{
+	NormalsJob job;
+	job.vertices	= mesh->pVertices();
+	job.triangles	= mesh->pTriangles();
+
+	int numVertices		= job.vertices->size();
+	int numTriangles	= job.triangles->size();
+	if(numVertices == 0 || numTriangles == 0)
+		return;
+
+	// face normals, one per triangle
+	job.faceNormals.resize(numTriangles);
+	WorkerPool::getInstance()->parallelFor(numTriangles, computeFaceNormals, &job);
+
+	// vertex -> triangles adjacency, so that every vertex sums its own faces without locking
+	job.offsets.assign(numVertices + 1, 0);
+	for(int t=0; t<numTriangles; t++)
+	{
+		cTriangle& triangle = (*job.triangles)[t];
+		if(!triangle.m_allocated) continue;
+		job.offsets[triangle.getIndexVertex0() + 1]++;
+		job.offsets[triangle.getIndexVertex1() + 1]++;
+		job.offsets[triangle.getIndexVertex2() + 1]++;
+	}
+	for(int v=0; v<numVertices; v++)
+		job.offsets[v+1] += job.offsets[v];
+
+	job.faceIndices.resize(job.offsets[numVertices]);
+	vector<int> fill(job.offsets.begin(), job.offsets.end() - 1);
+	for(int t=0; t<numTriangles; t++)
+	{
+		cTriangle& triangle = (*job.triangles)[t];
+		if(!triangle.m_allocated) continue;
+		job.faceIndices[fill[triangle.getIndexVertex0()]++] = t;
+		job.faceIndices[fill[triangle.getIndexVertex1()]++] = t;
+		job.faceIndices[fill[triangle.getIndexVertex2()]++] = t;
+	}
+
+	// vertex normals, one per vertex
+	WorkerPool::getInstance()->parallelFor(numVertices, computeVertexNormals, &job);
+}
+
+//=========================================================//
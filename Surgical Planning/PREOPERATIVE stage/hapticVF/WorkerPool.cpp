@@ -0,0 +1,320 @@
+/***************************************************************************
+Graphical/Haptic Simulation for Heart Catheterization Telerobotic Surgery
+Software: Surgical Planning - Preoperative Stage
+
+[Worker Pool]
+This is a singleton class that owns a fixed set of worker threads used for
+the heavy setup work (mesh parsing, normals computation) so that it can be
+split across all the available CPU cores.
+
+For more details, please refer to the documentation.
+
+Developed by Yasmin Halwani		(yasmin.halwani@outlook.com)
+Supervised by Dr. Osama Halabi	(ohalabi@qu.edu.qa)
+Computer Science and Engineering Department
+Qatar University
+2014
+****************************************************************************/
+
+#include "stdafx.h"
+
+/*=========================================================//
+//========================[VARIABLES]======================//
+//=========================================================*/
+bool			WorkerPool::instanceFlag	= false;
+WorkerPool*		WorkerPool::single			= NULL;
+
+// arguments of one chunk of a parallelFor call
+struct RangeJob
+{
+	WorkerRangeTask	task;
+	void*			arg;
+	int				begin;
+	int				end;
+};
+
+/*=========================================================//
+//==================[METHODS DEFINITIONS]==================//
+//=========================================================*/
+
+WorkerGroup::WorkerGroup()
+{
+	pendingJobs = 0;
+}
+
+//=========================================================//
+
+WorkerPool::WorkerPool(int numThreads)
+{
+	if(numThreads <= 0)
+		numThreads = getHardwareConcurrency();
+
+	this->numThreads	= numThreads;
+	isStopping			= false;
+
+#if defined(_WIN32)
+	InitializeCriticalSection(&mutex);
+	InitializeConditionVariable(&jobAvailable);
+	InitializeConditionVariable(&jobDone);
+#else
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&jobAvailable, NULL);
+	pthread_cond_init(&jobDone, NULL);
+#endif
+
+	for(int i=0; i<numThreads; i++)
+	{
+		WorkerThread thread;
+#if defined(_WIN32)
+		thread = (HANDLE)_beginthreadex(NULL, 0, threadEntry, this, 0, NULL);
+#else
+		pthread_create(&thread, NULL, threadEntry, this);
+#endif
+		threads.push_back(thread);
+	}
+}
+
+//=========================================================//
+
+WorkerPool* WorkerPool::getInstance(void)
+{
+    if(! instanceFlag)
+    {
+        single = new WorkerPool(0);
+        instanceFlag = true;
+        return single;
+    }
+    else
+    {
+        return single;
+    }
+}
+
+//=========================================================//
+
+WorkerPool::~WorkerPool(void)
+{
+	lock();
+	isStopping = true;
+	wakeAll(&jobAvailable);
+	unlock();
+
+	for(unsigned int i=0; i<threads.size(); i++)
+	{
+#if defined(_WIN32)
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+#else
+		pthread_join(threads[i], NULL);
+#endif
+	}
+
+#if defined(_WIN32)
+	DeleteCriticalSection(&mutex);
+#else
+	pthread_cond_destroy(&jobDone);
+	pthread_cond_destroy(&jobAvailable);
+	pthread_mutex_destroy(&mutex);
+#endif
+
+    instanceFlag = false;
+}
+
+//=========================================================//
+
+int WorkerPool::getHardwareConcurrency(void)
+{
+	int cores;
+#if defined(_WIN32)
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	cores = (int)info.dwNumberOfProcessors;
+#else
+	cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if(cores < 1) cores = 1;
+	return cores;
+}
+
+//=========================================================//
+
+#if defined(_WIN32)
+unsigned __stdcall WorkerPool::threadEntry(void* pool)
+{
+	((WorkerPool*)pool)->workerLoop();
+	return 0;
+}
+#else
+void* WorkerPool::threadEntry(void* pool)
+{
+	((WorkerPool*)pool)->workerLoop();
+	return NULL;
+}
+#endif
+
+//=========================================================//
+
+void WorkerPool::workerLoop(void)
+{
+	while(true)
+	{
+		lock();
+		while(jobs.empty() && !isStopping)
+			waitCondition(&jobAvailable);
+
+		if(jobs.empty())
+		{
+			// stopping and nothing left to run
+			unlock();
+			return;
+		}
+
+		Job job = jobs.front();
+		jobs.pop_front();
+		unlock();
+
+		runJob(job);
+	}
+}
+
+//=========================================================//
+
+void WorkerPool::runJob(Job job)
+{
+	job.task(job.arg);
+
+	lock();
+	if(job.group != NULL)
+		job.group->pendingJobs--;
+	wakeAll(&jobDone);
+	unlock();
+}
+
+//=========================================================//
+
+void WorkerPool::submit(WorkerTask task, void* arg, WorkerGroup* group)
+{
+	Job job;
+	job.task	= task;
+	job.arg		= arg;
+	job.group	= group;
+
+	lock();
+	if(group != NULL)
+		group->pendingJobs++;
+	jobs.push_back(job);
+	wakeAll(&jobAvailable);
+	unlock();
+}
+
+//=========================================================//
+
+void WorkerPool::wait(WorkerGroup* group)
+{
+	lock();
+	while(group->pendingJobs > 0)
+	{
+		if(!jobs.empty())
+		{
+			// help instead of sleeping; this also keeps nested waits from deadlocking
+			Job job = jobs.front();
+			jobs.pop_front();
+			unlock();
+			runJob(job);
+			lock();
+		}
+		else
+			waitCondition(&jobDone);
+	}
+	unlock();
+}
+
+//=========================================================//
+
+static void runRangeJob(void* arg)
+{
+	RangeJob* job = (RangeJob*)arg;
+	job->task(job->begin, job->end, job->arg);
+}
+
+//=========================================================//
+
+void WorkerPool::parallelFor(int count, WorkerRangeTask task, void* arg)
+{
+	if(count <= 0)
+		return;
+
+	// a few chunks per thread keeps the load balanced when chunks differ in cost
+	int numChunks = numThreads * 4;
+	if(numChunks > count) numChunks = count;
+	int chunkSize = (count + numChunks - 1) / numChunks;
+
+	vector<RangeJob> rangeJobs;
+	for(int begin=0; begin<count; begin+=chunkSize)
+	{
+		RangeJob job;
+		job.task	= task;
+		job.arg		= arg;
+		job.begin	= begin;
+		job.end		= (begin + chunkSize < count) ? begin + chunkSize : count;
+		rangeJobs.push_back(job);
+	}
+
+	WorkerGroup group;
+	for(unsigned int i=0; i<rangeJobs.size(); i++)
+		submit(runRangeJob, &rangeJobs[i], &group);
+	wait(&group);
+}
+
+//=========================================================//
+
+int WorkerPool::getNumThreads(void)
+{
+	return numThreads;
+}
+
+//=========================================================//
+
+void WorkerPool::lock(void)
+{
+#if defined(_WIN32)
+	EnterCriticalSection(&mutex);
+#else
+	pthread_mutex_lock(&mutex);
+#endif
+}
+
+//=========================================================//
+
+void WorkerPool::unlock(void)
+{
+#if defined(_WIN32)
+	LeaveCriticalSection(&mutex);
+#else
+	pthread_mutex_unlock(&mutex);
+#endif
+}
+
+//=========================================================//
+
+void WorkerPool::waitCondition(WorkerCondition* condition)
+{
+#if defined(_WIN32)
+	SleepConditionVariableCS(condition, &mutex, INFINITE);
+#else
+	pthread_cond_wait(condition, &mutex);
+#endif
+}
+
+//=========================================================//
+
+void WorkerPool::wakeAll(WorkerCondition* condition)
+{
+#if defined(_WIN32)
+	WakeAllConditionVariable(condition);
+#else
+	pthread_cond_broadcast(condition);
+#endif
+}
+
+//=========================================================//
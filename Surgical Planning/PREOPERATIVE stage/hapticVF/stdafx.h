@@ -29,11 +29,24 @@ Qatar University
 #include <iomanip>
 #include <fstream>
 #include <stdlib.h>
+#include <deque>
+#include <vector>
+#include <map>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
 
 using namespace std;
 
 // additional headers 
 #include "chai3d.h"
 #include "targetver.h"
+#include "WorkerPool.h"
+#include "ParallelMeshLoader.h"
 #include "CommonValues.h"
 #include "Point.h"